@@ -0,0 +1,11 @@
+#pragma once
+#include "Harness.hpp"
+
+auto benchJobSystem(bench::Harness& harness)        -> void;
+auto benchResizeStorm(bench::Harness& harness)      -> void;
+auto benchCommandRecording(bench::Harness& harness) -> void;
+auto benchHeadless(bench::Harness& harness)         -> void;
+auto benchMeshLoading(bench::Harness& harness)      -> void;
+auto benchDevice(bench::Harness& harness)           -> void;
+auto benchTransforms(bench::Harness& harness)       -> void;
+auto benchBvh(bench::Harness& harness)              -> void;
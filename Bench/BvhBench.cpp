@@ -0,0 +1,106 @@
+#include "Bench.hpp"
+#include "Bvh.hpp"
+#include <spdlog/spdlog.h>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Build, bulk refit, frustum and ray queries over unit boxes scattered at constant density, so
+// query results grow with the scene rather than the box size.
+auto benchBvh(bench::Harness& harness) -> void
+{
+    constexpr auto rayCount{ 1024u };
+
+    for (auto const instanceCount : std::array{ 1000u, 100000u, 1000000u })
+    {
+        auto const side{ std::cbrt(static_cast<f32>(instanceCount)) * 4.f };
+        auto const repetitions{ instanceCount > 100000u ? 5u : 0u };
+
+        auto random{ std::mt19937{ instanceCount } };
+        auto position{ std::uniform_real_distribution<f32>{ 0.f, side } };
+        auto jitter{ std::uniform_real_distribution<f32>{ -0.25f, 0.25f } };
+
+        auto bounds{ std::vector<Aabb>(instanceCount) };
+
+        for (auto& box : bounds)
+        {
+            for (auto axis{ 0u }; axis < 3; ++axis)
+            {
+                box.min[axis] = position(random);
+                box.max[axis] = box.min[axis] + 1.f;
+            }
+        }
+
+        auto bvh{ Bvh{} };
+
+        harness.run(fmt::format("Bvh build ({} instances)", instanceCount), [&]{ bvh.build(bounds); }, repetitions);
+
+        // Every box moves a little each run, alternating direction so the scene does not drift.
+        auto direction{ 1.f };
+
+        harness.run(fmt::format("Bvh refit ({} instances)", instanceCount), [&]{
+            for (auto item{ u32{} }; item < instanceCount; ++item)
+            {
+                auto const offset{ direction * 0.1f };
+
+                for (auto axis{ 0u }; axis < 3; ++axis)
+                {
+                    bounds[item].min[axis] += offset;
+                    bounds[item].max[axis] += offset;
+                }
+
+                bvh.update(item, bounds[item]);
+            }
+
+            bvh.refit();
+            direction = -direction;
+        }, repetitions);
+
+        // A 90 degree pyramid from the middle of one face, looking across the scene along +z.
+        auto const centerX{ side * 0.5f }, centerY{ side * 0.5f }, eyeZ{ -1.f };
+
+        auto const frustum{ Frustum{ .planes = {
+            {  1.f,  0.f, 1.f, -centerX - eyeZ },
+            { -1.f,  0.f, 1.f,  centerX - eyeZ },
+            {  0.f,  1.f, 1.f, -centerY - eyeZ },
+            {  0.f, -1.f, 1.f,  centerY - eyeZ },
+            {  0.f,  0.f, 1.f, -eyeZ - 0.1f },
+            {  0.f,  0.f, -1.f, eyeZ + side * 0.5f }
+        }}};
+
+        auto visible{ std::vector<u32>{} };
+
+        harness.run(fmt::format("Bvh frustum query ({} instances)", instanceCount), [&]{
+            visible.clear();
+            bvh.queryFrustum(frustum, visible);
+        });
+
+        auto rays{ std::vector<std::array<f32, 6>>(rayCount) };
+
+        for (auto& ray : rays)
+        {
+            ray = { position(random), position(random), eyeZ, jitter(random), jitter(random), 1.f };
+        }
+
+        auto hits{ u32{} };
+
+        harness.run(fmt::format("Bvh raycast ({} instances, {} rays)", instanceCount, rayCount), [&]{
+            hits = 0;
+
+            for (auto const& ray : rays)
+            {
+                hits += bvh.raycast(ray.data(), ray.data() + 3, side * 2.f).item != Bvh::noItem;
+            }
+        });
+
+        spdlog::info(
+            "Bvh [ instances: {}; nodes: {}; rebuilds: {}; visible: {}; ray hits: {} ]",
+            instanceCount,
+            bvh.getNodeCount(),
+            bvh.getRebuildCount(),
+            visible.size(),
+            hits
+        );
+    }
+}
@@ -0,0 +1,72 @@
+#include "Bench.hpp"
+#include "Instance.hpp"
+#include "PhysicalDevice.hpp"
+#include "Device.hpp"
+#include "Pipeline.hpp"
+#include "Buffer.hpp"
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <vector>
+
+// Buffer writes through both memory paths and pipeline construction, on an offscreen device.
+auto benchDevice(bench::Harness& harness) -> void
+{
+    constexpr auto size{ 1u << 20 };
+
+    // Only a missing Vulkan implementation or device skips the benchmark, as in the headless one.
+    try
+    {
+        auto instance      { vk::Instance{ false, false } };
+        auto physicalDevice{ vk::PhysicalDevice{ instance } };
+    }
+    catch (std::exception const& exception)
+    {
+        spdlog::warn("Skipped device benchmarks: {}", exception.what());
+        return;
+    }
+
+    auto instance      { vk::Instance{ false, false } };
+    auto physicalDevice{ vk::PhysicalDevice{ instance } };
+    auto device        { vk::Device{ instance, physicalDevice, glm::uvec2{ 1280, 720 } } };
+
+    auto data{ std::vector<u8>(size, 0x5a) };
+
+    {
+        auto buffer{ vk::Buffer{ device, size, vk::BufferUsage::eStorageBuffer, vk::MemoryType::eHost } };
+
+        harness.run("Buffer write (host, 1 MiB)", [&]{
+            buffer.write(data.data(), size);
+            buffer.flush(size);
+        });
+    }
+
+    {
+        auto buffer{ vk::Buffer{ device, size, vk::BufferUsage::eStorageBuffer, vk::MemoryType::eDevice } };
+
+        harness.run("Buffer write (device, 1 MiB)", [&]{
+            buffer.write(data.data(), size);
+            device.getUploader().wait(device.getUploader().flush());
+        });
+    }
+
+    auto camera{ vk::SwapBuffer{ device, sizeof(glm::mat4) * 3, vk::BufferUsage::eUniformBuffer, vk::MemoryType::eHost } };
+
+    harness.run("Pipeline creation", [&]{
+        auto pipeline{ vk::Pipeline{ device, vk::Pipeline::Config{
+            .point = vk::Pipeline::BindPoint::eGraphics,
+            .stages = {
+                { .stage = vk::ShaderStage::eVertex,   .path = "shaders/grid.vert.spv" },
+                { .stage = vk::ShaderStage::eFragment, .path = "shaders/grid.frag.spv" }
+            },
+            .descriptors = {
+                { 0, vk::ShaderStage::eVertex, vk::DescriptorType::eUniformBuffer, nullptr, &camera }
+            },
+            .topology = vk::Pipeline::Topology::eTriangleFan,
+            .cullMode = vk::Pipeline::CullMode::eFront,
+            .depthWrite = true,
+            .colorBlending = true
+        }}};
+    }, 10);
+
+    device.waitIdle();
+}
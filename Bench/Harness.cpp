@@ -0,0 +1,121 @@
+#include "Harness.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+// Benchmark names are free-form; quotes, backslashes and control characters are escaped so the
+// output stays valid JSON.
+static auto escapeJson(std::string_view text) -> std::string
+{
+    auto escaped{ std::string{} };
+    escaped.reserve(text.size());
+
+    for (auto const c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            escaped += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+bench::Harness::Harness(Options options)
+    : m{
+        .options = options
+    }
+{}
+
+auto bench::Harness::record(std::string_view name, std::vector<f64> samples) -> Result
+{
+    std::ranges::sort(samples);
+
+    // Nearest-rank percentiles, so p99 of fewer than a hundred samples is the maximum.
+    auto const percentile{ [&samples](f64 rank){
+        auto const index{ static_cast<size_t>(std::ceil(rank * static_cast<f64>(samples.size()))) };
+        return samples[std::clamp<size_t>(index, 1, samples.size()) - 1];
+    }};
+
+    auto& result{ m.results.emplace_back(Result{
+        .name = std::string{ name },
+        .samples = static_cast<u32>(samples.size())
+    })};
+
+    if (!samples.empty())
+    {
+        result.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<f64>(samples.size());
+        result.p50 = percentile(0.50);
+        result.p99 = percentile(0.99);
+        result.min = samples.front();
+        result.max = samples.back();
+    }
+
+    spdlog::info(
+        "{} [ samples: {}; mean: {:.4f} ms; p50: {:.4f} ms; p99: {:.4f} ms; min: {:.4f} ms; max: {:.4f} ms ]",
+        result.name,
+        result.samples,
+        result.mean,
+        result.p50,
+        result.p99,
+        result.min,
+        result.max
+    );
+
+    return result;
+}
+
+auto bench::Harness::writeJson(std::string_view path) const -> void
+{
+    auto file{ std::ofstream{ std::string{ path }, std::ios::trunc } };
+
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open benchmark output: " + std::string{ path });
+    }
+
+    auto out{ std::ostreambuf_iterator<char>{ file } };
+
+    fmt::format_to(
+        out,
+        "{{\n  \"unit\": \"ms\",\n  \"warmup\": {},\n  \"repetitions\": {},\n  \"results\": [",
+        m.options.warmup,
+        m.options.repetitions
+    );
+
+    for (auto i{ size_t{} }; i < m.results.size(); ++i)
+    {
+        auto const& result{ m.results[i] };
+
+        fmt::format_to(
+            out,
+            "{}\n    {{ \"name\": \"{}\", \"samples\": {}, \"mean\": {:.6f}, \"p50\": {:.6f}, \"p99\": {:.6f}, \"min\": {:.6f}, \"max\": {:.6f} }}",
+            i ? "," : "",
+            escapeJson(result.name),
+            result.samples,
+            result.mean,
+            result.p50,
+            result.p99,
+            result.min,
+            result.max
+        );
+    }
+
+    fmt::format_to(out, "\n  ]\n}}\n");
+
+    spdlog::info("Wrote benchmark results [ path: {}; results: {} ]", path, m.results.size());
+}
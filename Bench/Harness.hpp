@@ -0,0 +1,81 @@
+#pragma once
+#include "Types.hpp"
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+    struct Options
+    {
+        u32 warmup;
+        u32 repetitions;
+    };
+
+    // All times are in milliseconds.
+    struct Result
+    {
+        std::string name;
+        u32         samples;
+        f64         mean;
+        f64         p50;
+        f64         p99;
+        f64         min;
+        f64         max;
+    };
+
+    class Harness
+    {
+    public:
+        Harness(Options options);
+        ~Harness() = default;
+        Harness(Harness const&) = delete;
+        Harness(Harness&&) = delete;
+        auto operator=(Harness const&) -> Harness& = delete;
+        auto operator=(Harness&&) -> Harness& = delete;
+
+    public:
+        // Calls the function warmup times untimed, then times each of the repetitions.
+        // A non-zero repetitions argument overrides the harness default for cheap cases.
+        template<typename F>
+        auto run(std::string_view name, F&& function, u32 repetitions = 0) -> Result
+        {
+            for (auto i{ u32{} }; i < m.options.warmup; ++i)
+            {
+                function();
+            }
+
+            auto const count{ repetitions ? repetitions : m.options.repetitions };
+            auto samples{ std::vector<f64>{} };
+            samples.reserve(count);
+
+            for (auto i{ u32{} }; i < count; ++i)
+            {
+                auto const start{ std::chrono::steady_clock::now() };
+                function();
+                samples.emplace_back(std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            return this->record(name, std::move(samples));
+        }
+
+        // For benchmarks that collect their own samples, e.g. per-frame times of one long run.
+        auto record(std::string_view name, std::vector<f64> samples) -> Result;
+        auto writeJson(std::string_view path) const -> void;
+
+    public:
+        inline auto getOptions() const noexcept -> Options const&
+        {
+            return m.options;
+        }
+
+    private:
+        struct M
+        {
+            Options             options;
+            std::vector<Result> results;
+        } m;
+    };
+}
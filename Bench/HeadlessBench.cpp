@@ -0,0 +1,134 @@
+#include "Bench.hpp"
+#include "Renderer.hpp"
+#include "Camera.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+
+// Drives the normal frame loop against offscreen targets, so it also runs on machines without
+// a display, e.g. with a software implementation such as lavapipe.
+auto benchHeadless(bench::Harness& harness) -> void
+{
+    constexpr auto extent      { glm::uvec2{ 1280, 720 } };
+    constexpr auto frameCount  { 300u };
+    constexpr auto instanceGrid{ 128u };
+
+    // Only a missing Vulkan implementation or device skips the benchmark; anything that fails once
+    // a device exists propagates and fails the run.
+    try
+    {
+        auto instance      { vk::Instance{ false, false } };
+        auto physicalDevice{ vk::PhysicalDevice{ instance } };
+    }
+    catch (std::exception const& exception)
+    {
+        spdlog::warn("Skipped headless frames: {}", exception.what());
+        return;
+    }
+
+    auto renderer{ Renderer{ extent } };
+    auto camera  { Camera{} };
+
+    renderer.setCamera(&camera);
+
+    auto const paths{ std::array{
+        std::pair{ Renderer::GeometryPath::eIndirect,       "Headless frame (indirect)" },
+        std::pair{ Renderer::GeometryPath::eMeshletCompute, "Headless frame (meshlets, compute culling)" },
+        std::pair{ Renderer::GeometryPath::eMeshShader,     "Headless frame (meshlets, mesh shading)" }
+    }};
+
+    for (auto const& [path, name] : paths)
+    {
+        if (path == Renderer::GeometryPath::eMeshShader && !renderer.getDevice().hasMeshShader())
+        {
+            continue;
+        }
+
+        renderer.setGeometryPath(path);
+        harness.run(name, [&]{ renderer.renderFrame(); }, frameCount);
+
+        if (path == Renderer::GeometryPath::eIndirect)
+        {
+            spdlog::info(
+                "Indexed draws [ visible instances: {}; triangles: {} ]",
+                renderer.getVisibleInstanceCount(),
+                renderer.getDrawnTriangleCount()
+            );
+        }
+    }
+
+    // Frame times while another copy of the model is imported and uploaded in the background.
+    auto const model{ renderer.loadModelAsync("Assets/Models/kitten.obj") };
+    auto streamingFrames{ std::vector<f64>{} };
+
+    while (renderer.getModelState(model) != Renderer::ModelState::eResident && renderer.getModelState(model) != Renderer::ModelState::eFailed)
+    {
+        auto const start{ std::chrono::steady_clock::now() };
+        renderer.renderFrame();
+        streamingFrames.emplace_back(std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    auto const streaming{ harness.record("Headless frame (model streaming)", std::move(streamingFrames)) };
+    spdlog::info("Model streaming [ frames: {}; worst frame: {:.3f} ms ]", streaming.samples, streaming.max);
+
+    // A grid of copies of every loaded mesh, still drawn with one indirect command per mesh and LOD.
+    auto const meshCount{ renderer.getMeshCount() };
+
+    for (auto z{ 0u }; z < instanceGrid; ++z)
+    {
+        for (auto x{ 0u }; x < instanceGrid; ++x)
+        {
+            for (auto mesh{ 0u }; mesh < meshCount && (x || z); ++mesh)
+            {
+                renderer.addInstance(mesh, Transform{
+                    .position = { static_cast<f32>(x) * 2.f, 0.f, static_cast<f32>(z) * 2.f }
+                });
+            }
+        }
+    }
+
+    renderer.setGeometryPath(Renderer::GeometryPath::eIndirect);
+    harness.run(fmt::format("Headless frame (indirect, {} instances)", renderer.getTransforms().size()), [&]{ renderer.renderFrame(); }, frameCount);
+
+    spdlog::info(
+        "Instanced draws [ instances: {}; visible instances: {}; triangles: {} ]",
+        renderer.getTransforms().size(),
+        renderer.getVisibleInstanceCount(),
+        renderer.getDrawnTriangleCount()
+    );
+
+    renderer.waitIdle();
+
+    auto const pixels{ renderer.readback() };
+    auto const lit{ std::ranges::count_if(pixels, [](u8 value){ return value != 0; }) };
+
+    spdlog::info(
+        "Headless frames [ width: {}; height: {}; non-zero bytes: {} / {} ]",
+        extent.x,
+        extent.y,
+        lit,
+        pixels.size()
+    );
+
+    // The renderer leaves an ImGui frame open; close it to get draw data, then reopen it.
+    ImGui::ShowDemoWindow();
+    ImGui::Render();
+
+    auto const drawData{ ImGui::GetDrawData() };
+
+    harness.run("ImGui packing", [&]{ renderer.packImgui(drawData); });
+
+    spdlog::info(
+        "ImGui packing [ vertices: {}; indices: {}; lists: {} ]",
+        drawData->TotalVtxCount,
+        drawData->TotalIdxCount,
+        drawData->CmdListsCount
+    );
+
+    ImGui::NewFrame();
+    renderer.waitIdle();
+}
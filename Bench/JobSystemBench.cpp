@@ -0,0 +1,64 @@
+#include "Bench.hpp"
+#include "JobSystem.hpp"
+#include "Thread.hpp"
+#include <spdlog/spdlog.h>
+#include <vector>
+
+static auto work(u32 seed, u32 iterations) -> u32
+{
+    auto hash{ seed * 2654435761u };
+
+    for (auto i{ u32{} }; i < iterations; ++i)
+    {
+        hash ^= hash << 13;
+        hash ^= hash >> 17;
+        hash ^= hash << 5;
+    }
+
+    return hash;
+}
+
+static auto runCase(bench::Harness& harness, char const* name, u32 jobCount, u32 iterations) -> void
+{
+    auto results{ std::vector<u32>(jobCount) };
+
+    // Both workers exist before timing starts, so only scheduling and execution are measured.
+    auto thread   { Thread{} };
+    auto jobSystem{ JobSystem{} };
+
+    auto const threadTime{ harness.run(fmt::format("{}: Thread", name), [&]
+    {
+        for (auto i{ u32{} }; i < jobCount; ++i)
+        {
+            thread.enqueue([&results, i, iterations]{ results[i] = work(i, iterations); });
+        }
+
+        thread.wait();
+    }).mean };
+
+    auto const jobSystemTime{ harness.run(fmt::format("{}: JobSystem", name), [&]
+    {
+        auto counter{ JobSystem::Counter{} };
+
+        for (auto i{ u32{} }; i < jobCount; ++i)
+        {
+            jobSystem.schedule(counter, [&results, i, iterations]{ results[i] = work(i, iterations); });
+        }
+
+        jobSystem.wait(counter);
+    }).mean };
+
+    spdlog::info(
+        "{} [ jobs: {}; JobSystem workers: {}; speedup over Thread: {:.2f}x ]",
+        name,
+        jobCount,
+        jobSystem.getWorkerCount(),
+        threadTime / jobSystemTime
+    );
+}
+
+auto benchJobSystem(bench::Harness& harness) -> void
+{
+    runCase(harness, "Tiny jobs", 10'000, 16);
+    runCase(harness, "Large jobs", 100, 2'000'000);
+}
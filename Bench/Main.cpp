@@ -0,0 +1,47 @@
+#include "Bench.hpp"
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+
+int main(int argc, char** argv)
+{
+    auto options{ bench::Options{ .warmup = 3, .repetitions = 30 } };
+    auto json   { std::string{ "bench.json" } };
+
+    for (auto i{ 1 }; i + 1 < argc; i += 2)
+    {
+        auto const arg{ std::string_view{ argv[i] } };
+
+        if (arg == "--json")
+        {
+            json = argv[i + 1];
+        }
+        else if (arg == "--warmup")
+        {
+            options.warmup = static_cast<u32>(std::stoul(argv[i + 1]));
+        }
+        else if (arg == "--repetitions")
+        {
+            options.repetitions = static_cast<u32>(std::stoul(argv[i + 1]));
+        }
+        else
+        {
+            spdlog::warn("Unknown argument: {}", arg);
+        }
+    }
+
+    auto harness{ bench::Harness{ options } };
+
+    benchJobSystem(harness);
+    benchResizeStorm(harness);
+    benchCommandRecording(harness);
+    benchHeadless(harness);
+    benchMeshLoading(harness);
+    benchDevice(harness);
+    benchTransforms(harness);
+    benchBvh(harness);
+
+    harness.writeJson(json);
+
+    return 0;
+}
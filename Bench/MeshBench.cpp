@@ -0,0 +1,41 @@
+#include "Bench.hpp"
+#include "MeshLoader.hpp"
+#include "JobSystem.hpp"
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+// A fresh loader per repetition, since the loader accumulates geometry across calls. Imports
+// bypass the mesh cache; the last case measures loading from the cache written by the others.
+auto benchMeshLoading(bench::Harness& harness) -> void
+{
+    constexpr auto path{ "Assets/Models/kitten.obj" };
+
+    try
+    {
+        auto jobs{ JobSystem{} };
+
+        auto vertexCount{ size_t{} };
+        auto indexCount { size_t{} };
+
+        auto const load{ [&](JobSystem* jobSystem, bool cacheEnabled){
+            auto loader{ MeshLoader{ jobSystem } };
+            loader.setCacheEnabled(cacheEnabled);
+            loader.loadMesh(path, false);
+
+            vertexCount = loader.positions.size() / 3;
+            indexCount = loader.indices.size();
+        }};
+
+        harness.run("Mesh loading (import)", [&]{ load(nullptr, false); });
+        harness.run(fmt::format("Mesh loading (import, {} workers)", jobs.getWorkerCount()), [&]{ load(&jobs, false); });
+
+        load(nullptr, true);
+        harness.run("Mesh loading (cache)", [&]{ load(nullptr, true); });
+
+        spdlog::info("Mesh loading [ path: {}; vertices: {}; indices: {} ]", path, vertexCount, indexCount);
+    }
+    catch (std::exception const& exception)
+    {
+        spdlog::warn("Skipped mesh loading: {}", exception.what());
+    }
+}
@@ -0,0 +1,99 @@
+#include "Bench.hpp"
+#include "Instance.hpp"
+#include "PhysicalDevice.hpp"
+#include "Device.hpp"
+#include "Pipeline.hpp"
+#include "Buffer.hpp"
+#include "Image.hpp"
+#include "CommandBuffer.hpp"
+#include "JobSystem.hpp"
+#include <spdlog/spdlog.h>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+// Records the same set of secondary command buffers with a growing number of threads. Every
+// secondary owns its pool, so recording needs no synchronisation beyond the job counter.
+auto benchCommandRecording(bench::Harness& harness) -> void
+{
+    constexpr auto chunkCount   { 64u };
+    constexpr auto drawsPerChunk{ 1024u };
+
+    try
+    {
+        auto instance      { vk::Instance{ false, false } };
+        auto physicalDevice{ vk::PhysicalDevice{ instance } };
+        auto device        { vk::Device{ instance, physicalDevice, glm::uvec2{ 1280, 720 } } };
+
+        auto camera{ vk::SwapBuffer{ device, sizeof(glm::mat4) * 3, vk::BufferUsage::eUniformBuffer, vk::MemoryType::eHost } };
+        auto color { vk::Image{ &device, device.getExtent(), vk::ImageUsage::eColorAttachment, vk::Format::eRGBA8_unorm } };
+        auto depth { vk::Image{ &device, device.getExtent(), vk::ImageUsage::eDepthAttachment, vk::Format::eD32_sfloat } };
+
+        auto pipeline{ vk::Pipeline{ device, vk::Pipeline::Config{
+            .point = vk::Pipeline::BindPoint::eGraphics,
+            .stages = {
+                { .stage = vk::ShaderStage::eVertex,   .path = "shaders/grid.vert.spv" },
+                { .stage = vk::ShaderStage::eFragment, .path = "shaders/grid.frag.spv" }
+            },
+            .descriptors = {
+                { 0, vk::ShaderStage::eVertex, vk::DescriptorType::eUniformBuffer, nullptr, &camera }
+            },
+            .topology = vk::Pipeline::Topology::eTriangleFan,
+            .cullMode = vk::Pipeline::CullMode::eFront,
+            .depthWrite = true,
+            .colorBlending = true
+        }}};
+
+        auto chunks{ std::vector<vk::CommandBuffer>(chunkCount) };
+
+        for (auto& chunk : chunks)
+        {
+            chunk.allocate(&device, vk::QueueType::eGraphics, vk::CommandBufferLevel::eSecondary);
+        }
+
+        auto baseline{ f64{} };
+
+        for (auto const threadCount : std::array{ 1u, 2u, 4u, 8u })
+        {
+            auto jobs{ JobSystem{ threadCount - 1 } };
+
+            auto const result{ harness.run(fmt::format("Command recording ({} threads)", threadCount), [&]{
+                auto counter{ JobSystem::Counter{} };
+
+                jobs.parallelFor(counter, chunkCount, 1, [&](u32 begin, u32 end){
+                    for (auto chunk{ begin }; chunk < end; ++chunk)
+                    {
+                        auto& commands{ chunks[chunk] };
+
+                        commands.beginInherited(0, color, &depth);
+                        commands.bindPipeline(pipeline);
+
+                        for (auto draw{ u32{} }; draw < drawsPerChunk; ++draw)
+                        {
+                            commands.draw(4);
+                        }
+
+                        commands.end();
+                    }
+                });
+
+                jobs.wait(counter);
+            })};
+
+            baseline = baseline == 0.0 ? result.mean : baseline;
+
+            spdlog::info(
+                "Command recording [ threads: {}; draws: {}; speedup: {:.2f}x ]",
+                threadCount,
+                chunkCount * drawsPerChunk,
+                baseline / result.mean
+            );
+        }
+
+        device.waitIdle();
+    }
+    catch (std::exception const& exception)
+    {
+        spdlog::warn("Skipped command recording: {}", exception.what());
+    }
+}
@@ -0,0 +1,67 @@
+#include "Bench.hpp"
+#include "Window.hpp"
+#include "Renderer.hpp"
+#include "Camera.hpp"
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Alternates the window size every few frames. With idleOnResize the device is drained before
+// every resize, which is what swapchain recreation did before destruction was deferred.
+static auto runStorm(bench::Harness& harness, Window& window, Renderer& renderer, std::string_view name, bool idleOnResize) -> void
+{
+    constexpr auto frameCount{ 240u };
+    constexpr auto resizeInterval{ 4u };
+
+    auto steadyTimes{ std::vector<f64>{} };
+    auto resizeTimes{ std::vector<f64>{} };
+
+    for (auto i{ u32{} }; i < frameCount && window.available(); ++i)
+    {
+        auto const resize{ i % resizeInterval == 0 };
+        auto const start{ std::chrono::steady_clock::now() };
+
+        if (resize)
+        {
+            window.setSize((i / resizeInterval) % 2 ? glm::ivec2{ 1280, 720 } : glm::ivec2{ 960, 540 });
+
+            if (idleOnResize)
+            {
+                renderer.waitIdle();
+            }
+        }
+
+        renderer.renderFrame();
+        window.update();
+
+        auto const time{ std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count() };
+        (resize ? resizeTimes : steadyTimes).push_back(time);
+    }
+
+    harness.record(fmt::format("{}: steady frames", name), std::move(steadyTimes));
+    harness.record(fmt::format("{}: resize frames", name), std::move(resizeTimes));
+}
+
+auto benchResizeStorm(bench::Harness& harness) -> void
+{
+    try
+    {
+        auto window  { Window{} };
+        auto renderer{ Renderer{ window } };
+        auto camera  { Camera{} };
+
+        renderer.setCamera(&camera);
+
+        runStorm(harness, window, renderer, "Resize storm with device idle", true);
+        runStorm(harness, window, renderer, "Resize storm with deferred destruction", false);
+
+        renderer.waitIdle();
+    }
+    catch (std::exception const& exception)
+    {
+        spdlog::warn("Skipped resize storm: {}", exception.what());
+    }
+}
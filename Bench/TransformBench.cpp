@@ -0,0 +1,28 @@
+#include "Bench.hpp"
+#include "TransformStore.hpp"
+#include <spdlog/spdlog.h>
+#include <vector>
+
+// Bulk updates over the structure of arrays against packing them into GPU rows, at the
+// renderer's instance capacity.
+auto benchTransforms(bench::Harness& harness) -> void
+{
+    constexpr auto instanceCount{ 1u << 16 };
+
+    auto store{ TransformStore{} };
+
+    for (auto i{ 0u }; i < instanceCount; ++i)
+    {
+        store.add(Transform{
+            .position = { static_cast<f32>(i % 256), 0.f, static_cast<f32>(i / 256) },
+            .rotation = { 0.f, 0.38268343f, 0.f, 0.92387953f }
+        });
+    }
+
+    auto rows{ std::vector<f32>(instanceCount * 16) };
+
+    harness.run("Transforms (translate)", [&]{ store.translate(0, instanceCount, 0.01f, 0.f, -0.01f); });
+    harness.run("Transforms (pack rows)", [&]{ store.writeRows(rows.data(), sizeof(f32) * 16, 0, store.size()); });
+
+    spdlog::info("Transforms [ instances: {}; version: {} ]", store.size(), store.getVersion());
+}
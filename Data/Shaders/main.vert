@@ -1,5 +1,5 @@
 #version 460
-#extension GL_EXT_shader_8bit_storage: require 
+#extension GL_EXT_shader_16bit_storage: require
 
 struct Camera
 { 
@@ -8,23 +8,62 @@ struct Camera
     mat4 projView;
 };
 
-layout(std430, binding = 0) restrict readonly buffer  IndexBuffer   { uint    indices[];   };
-layout(std430, binding = 1) restrict readonly buffer  PositionBuffer{ float   positions[]; };
-layout(std430, binding = 2) restrict readonly buffer  UvBuffer      { float   uvs[];       };
-layout(std430, binding = 3) restrict readonly buffer  NormalBuffer  { uint8_t normals[];   };
-layout(        binding = 4) restrict readonly uniform UniformBuffer { Camera  camera;      };
+struct MeshParams
+{
+    vec3 positionOffset;
+    uint vertexOffset;
+    vec3 positionScale;
+    uint normalBits;
+};
+
+struct Instance
+{
+    vec4  rows[3];
+    uint  mesh;
+    float scale;
+    uint  padding[2];
+};
+
+layout(std430, binding = 1) restrict readonly buffer  PositionBuffer{ uint16_t   positions[]; };
+layout(std430, binding = 2) restrict readonly buffer  UvBuffer      { uint       uvs[];       };
+layout(std430, binding = 3) restrict readonly buffer  NormalBuffer  { uint       normals[];   };
+layout(        binding = 4) restrict readonly uniform UniformBuffer { Camera     camera;      };
+layout(std430, binding = 5) restrict readonly buffer  ParamsBuffer  { MeshParams params[];    };
+layout(std430, binding = 6) restrict readonly buffer  InstanceBuffer{ Instance   instances[]; };
+layout(std430, binding = 7) restrict readonly buffer  VisibleBuffer { uint       visible[];   };
 
 layout(location = 0) out vec3 outNormal;
 
+vec3 decodePosition(uint id, MeshParams mesh)
+{
+    return mesh.positionOffset + mesh.positionScale * vec3(uint(positions[id * 3]), uint(positions[id * 3 + 1]), uint(positions[id * 3 + 2]));
+}
+
+// Octahedral decode; the folded lower hemisphere is unwrapped by the z < 0 correction.
+vec3 decodeNormal(uint id, MeshParams mesh)
+{
+    vec2 e = vec2(bitfieldExtract(int(normals[id]), 0, 16), bitfieldExtract(int(normals[id]), 16, 16)) / float((1 << (mesh.normalBits - 1)) - 1);
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+
+    return normalize(n);
+}
+
+// One indexed draw per mesh and LOD: the instance index points at a slot the culling pass filled
+// with a visible instance, and the vertex index already includes the mesh's vertex offset.
+// Scale is uniform, so the upper 3x3 of the transform also carries normals.
 void main()
 {
-    uint id = indices[gl_VertexIndex];
+    Instance instance = instances[visible[gl_InstanceIndex]];
+    MeshParams mesh = params[instance.mesh];
+    uint id = gl_VertexIndex;
+
+    vec4 position = vec4(decodePosition(id, mesh), 1.0);
+    vec3 normal = decodeNormal(id, mesh);
 
-    outNormal = vec3(
-        int(normals[id * 3    ]),
-        int(normals[id * 3 - 1]),
-        int(normals[id * 3 - 2])
-    ) / 127.0 - 1.0;
+    outNormal = normalize(vec3(dot(instance.rows[0].xyz, normal), dot(instance.rows[1].xyz, normal), dot(instance.rows[2].xyz, normal)));
 
-    gl_Position = camera.projView * vec4(positions[id * 3], positions[id * 3 + 1], positions[id * 3 + 2], 1.0);
+    gl_Position = camera.projView * vec4(dot(instance.rows[0], position), dot(instance.rows[1], position), dot(instance.rows[2], position), 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#version 460
+#extension GL_EXT_shader_8bit_storage: require
+#extension GL_EXT_shader_16bit_storage: require
+
+struct Meshlet
+{
+    vec3 center;
+    float radius;
+    uint cone;
+    uint vertexOffset;
+    uint triangleOffset;
+    uint counts;
+};
+
+struct MeshParams
+{
+    vec3 positionOffset;
+    uint vertexOffset;
+    vec3 positionScale;
+    uint normalBits;
+};
+
+struct Camera
+{
+    mat4 projection;
+    mat4 view;
+    mat4 projView;
+};
+
+layout(std430, binding = 0) restrict readonly buffer  MeshletBuffer  { Meshlet    meshlets[];  };
+layout(std430, binding = 1) restrict readonly buffer  VertexBuffer   { uint       vertices[];  };
+layout(std430, binding = 2) restrict readonly buffer  TriangleBuffer { uint8_t    triangles[]; };
+layout(std430, binding = 3) restrict readonly buffer  PositionBuffer { uint16_t   positions[]; };
+layout(std430, binding = 4) restrict readonly buffer  NormalBuffer   { uint       normals[];   };
+layout(        binding = 5) restrict readonly uniform UniformBuffer  { Camera     camera;      };
+layout(std430, binding = 6) restrict readonly buffer  ParamsBuffer   { MeshParams params[];    };
+
+layout(location = 0) out vec3 outNormal;
+
+vec3 decodePosition(uint id, MeshParams mesh)
+{
+    return mesh.positionOffset + mesh.positionScale * vec3(uint(positions[id * 3]), uint(positions[id * 3 + 1]), uint(positions[id * 3 + 2]));
+}
+
+// Octahedral decode; the folded lower hemisphere is unwrapped by the z < 0 correction.
+vec3 decodeNormal(uint id, MeshParams mesh)
+{
+    vec2 e = vec2(bitfieldExtract(int(normals[id]), 0, 16), bitfieldExtract(int(normals[id]), 16, 16)) / float((1 << (mesh.normalBits - 1)) - 1);
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+
+    return normalize(n);
+}
+
+// One instance per surviving meshlet: firstInstance carries the meshlet, the vertex index walks its triangles.
+void main()
+{
+    Meshlet meshlet = meshlets[gl_InstanceIndex];
+    MeshParams mesh = params[meshlet.counts >> 16];
+
+    uint id = vertices[meshlet.vertexOffset + uint(triangles[meshlet.triangleOffset + gl_VertexIndex])];
+
+    outNormal = decodeNormal(id, mesh);
+
+    gl_Position = camera.projView * vec4(decodePosition(id, mesh), 1.0);
+}
\ No newline at end of file
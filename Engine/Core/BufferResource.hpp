@@ -1,9 +1,234 @@
 #pragma once
+#include "Types.hpp"
 #include <memory_resource>
+#include <algorithm>
 #include <array>
 
 namespace pmr
 {
-    inline std::array<std::uint8_t, 1024 * 512> g_stackBuffer;
-    inline std::pmr::monotonic_buffer_resource g_rsrc(g_stackBuffer.data(), g_stackBuffer.size());
+    struct ArenaStats
+    {
+        size_t capacity;
+        size_t used;
+        size_t highWater;
+        size_t overflowCount;
+        size_t overflowBytes;
+    };
+
+    // Linear allocator over a fixed buffer. Requests that do not fit spill to the upstream
+    // resource and are counted as overflows, so a non-zero overflow count means the buffer is too small.
+    class Arena : public std::pmr::memory_resource
+    {
+    public:
+        struct Marker
+        {
+            size_t offset;
+            size_t overflowSerial;
+        };
+
+    public:
+        Arena(void* pBuffer, size_t size, std::pmr::memory_resource* pUpstream = std::pmr::new_delete_resource()) noexcept
+            : m{
+                .buffer = static_cast<u8*>(pBuffer),
+                .upstream = pUpstream,
+                .capacity = size
+            }
+        {}
+
+        ~Arena() override
+        {
+            this->reset();
+        }
+
+        Arena(Arena const&) = delete;
+        Arena(Arena&&) = delete;
+        auto operator=(Arena const&) -> Arena& = delete;
+        auto operator=(Arena&&) -> Arena& = delete;
+
+    public:
+        inline auto getMarker() const noexcept -> Marker
+        {
+            return { m.offset, m.overflowSerial };
+        }
+
+        auto rewind(Marker marker) noexcept -> void
+        {
+            while (m.overflows && m.overflows->serial >= marker.overflowSerial)
+            {
+                this->release(m.overflows);
+            }
+
+            m.offset = std::min(m.offset, marker.offset);
+        }
+
+        inline auto reset() noexcept -> void
+        {
+            this->rewind({});
+        }
+
+        inline auto getStats() const noexcept -> ArenaStats
+        {
+            return {
+                .capacity = m.capacity,
+                .used = m.offset,
+                .highWater = m.highWater,
+                .overflowCount = m.overflowCount,
+                .overflowBytes = m.overflowBytes
+            };
+        }
+
+    private:
+        struct Overflow
+        {
+            Overflow* prev;
+            Overflow* next;
+            size_t    size;
+            size_t    alignment;
+            size_t    serial;
+        };
+
+        static inline auto headerSize(size_t alignment) noexcept -> size_t
+        {
+            auto const align{ std::max(alignment, alignof(Overflow)) };
+            return (sizeof(Overflow) + align - 1) & ~(align - 1);
+        }
+
+        auto release(Overflow* pNode) noexcept -> void
+        {
+            (pNode->prev ? pNode->prev->next : m.overflows) = pNode->next;
+
+            if (pNode->next)
+            {
+                pNode->next->prev = pNode->prev;
+            }
+
+            m.upstream->deallocate(
+                pNode,
+                pNode->size + headerSize(pNode->alignment),
+                std::max(pNode->alignment, alignof(Overflow))
+            );
+        }
+
+        auto do_allocate(size_t size, size_t alignment) -> void* override
+        {
+            auto const base   { reinterpret_cast<uintptr_t>(m.buffer) };
+            auto const aligned{ (base + m.offset + alignment - 1) & ~(alignment - 1) };
+            auto const end    { aligned - base + size };
+
+            if (m.buffer && end <= m.capacity) [[likely]]
+            {
+                m.offset = end;
+                m.highWater = std::max(m.highWater, m.offset);
+
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            auto const header{ headerSize(alignment) };
+            auto const node{ static_cast<Overflow*>(m.upstream->allocate(size + header, std::max(alignment, alignof(Overflow)))) };
+
+            *node = Overflow{
+                .next = m.overflows,
+                .size = size,
+                .alignment = alignment,
+                .serial = m.overflowSerial++
+            };
+
+            if (m.overflows)
+            {
+                m.overflows->prev = node;
+            }
+
+            m.overflows = node;
+            ++m.overflowCount;
+            m.overflowBytes += size;
+
+            return reinterpret_cast<u8*>(node) + header;
+        }
+
+        auto do_deallocate(void* p, size_t size, size_t alignment) -> void override
+        {
+            auto const pointer{ static_cast<u8*>(p) };
+
+            if (pointer >= m.buffer && pointer < m.buffer + m.capacity)
+            {
+                if (pointer + size == m.buffer + m.offset)
+                {
+                    m.offset = static_cast<size_t>(pointer - m.buffer);
+                }
+
+                return;
+            }
+
+            this->release(reinterpret_cast<Overflow*>(pointer - headerSize(alignment)));
+        }
+
+        auto do_is_equal(std::pmr::memory_resource const& other) const noexcept -> bool override
+        {
+            return this == &other;
+        }
+
+    private:
+        struct M
+        {
+            u8*                         buffer;
+            std::pmr::memory_resource*  upstream;
+            Overflow*                   overflows;
+            size_t                      capacity;
+            size_t                      offset;
+            size_t                      highWater;
+            size_t                      overflowCount;
+            size_t                      overflowBytes;
+            size_t                      overflowSerial;
+        } m;
+    };
+
+    // Rewinds the calling thread's scratch arena when it goes out of scope.
+    class ScratchScope
+    {
+    public:
+        ScratchScope();
+        ~ScratchScope();
+        ScratchScope(ScratchScope const&) = delete;
+        ScratchScope(ScratchScope&&) = delete;
+        auto operator=(ScratchScope const&) -> ScratchScope& = delete;
+        auto operator=(ScratchScope&&) -> ScratchScope& = delete;
+
+    public:
+        inline auto get() noexcept -> std::pmr::memory_resource*
+        {
+            return &m.arena;
+        }
+
+    private:
+        struct M
+        {
+            Arena&        arena;
+            Arena::Marker marker;
+        } m;
+    };
+
+    // Lives for the whole run: script names, swapchain and per-frame buffer tables.
+    inline std::array<u8, 1024 * 512> g_persistentBuffer;
+    inline Arena g_persistentArena(g_persistentBuffer.data(), g_persistentBuffer.size());
+
+    // Reset at the end of every engine loop iteration.
+    inline std::array<u8, 1024 * 256> g_frameBuffer;
+    inline Arena g_frameArena(g_frameBuffer.data(), g_frameBuffer.size());
+
+    inline auto scratch() -> Arena&
+    {
+        thread_local std::array<u8, 1024 * 64> buffer;
+        thread_local Arena arena(buffer.data(), buffer.size());
+
+        return arena;
+    }
+
+    inline ScratchScope::ScratchScope()
+        : m{ scratch(), scratch().getMarker() }
+    {}
+
+    inline ScratchScope::~ScratchScope()
+    {
+        m.arena.rewind(m.marker);
+    }
 }
@@ -0,0 +1,272 @@
+#pragma once
+#include "Types.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+
+    class Counter
+    {
+    public:
+        Counter() = default;
+        ~Counter() = default;
+        Counter(Counter const&) = delete;
+        Counter(Counter&&) = delete;
+        auto operator=(Counter const&) -> Counter& = delete;
+        auto operator=(Counter&&) -> Counter& = delete;
+
+    public:
+        inline auto done() const noexcept -> bool
+        {
+            return m.value.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        friend class JobSystem;
+
+        struct M
+        {
+            std::atomic<u32> value;
+        } m{};
+    };
+
+public:
+    explicit JobSystem(u32 workerCount = defaultWorkerCount())
+    {
+        m.queueCount = std::max(workerCount, 1u);
+        m.queues = std::make_unique<Queue[]>(m.queueCount);
+        m.workers.reserve(workerCount);
+
+        for (auto i{ u32{} }; i < workerCount; ++i)
+        {
+            m.workers.emplace_back(&JobSystem::workerLoop, this, i);
+        }
+    }
+
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m.sleepMutex);
+            m.running.store(false);
+        }
+        m.sleepCondition.notify_all();
+
+        for (auto& worker : m.workers)
+        {
+            worker.join();
+        }
+    }
+
+    JobSystem(JobSystem const&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    auto operator=(JobSystem const&) -> JobSystem& = delete;
+    auto operator=(JobSystem&&) -> JobSystem& = delete;
+
+public:
+    auto schedule(Counter& counter, Job&& job) -> void
+    {
+        counter.m.value.fetch_add(1, std::memory_order_relaxed);
+
+        auto& queue{ m.queues[homeQueue()] };
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(Entry{ std::move(job), &counter });
+        }
+
+        m.pending.fetch_add(1);
+
+        if (m.sleepers.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(m.sleepMutex);
+            m.sleepCondition.notify_one();
+        }
+    }
+
+    // Long-running work such as asset imports. Only pool workers pick it up, and only when their
+    // own queues are empty, so a thread waiting on frame work from outside never runs it.
+    auto scheduleBackground(Counter& counter, Job&& job) -> void
+    {
+        counter.m.value.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(m.background.mutex);
+            m.background.jobs.push_back(Entry{ std::move(job), &counter });
+        }
+
+        m.pending.fetch_add(1);
+
+        if (m.sleepers.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(m.sleepMutex);
+            m.sleepCondition.notify_one();
+        }
+    }
+
+    template<typename F>
+    auto parallelFor(Counter& counter, u32 count, u32 batchSize, F const& function) -> void
+    {
+        batchSize = std::max(batchSize, 1u);
+
+        for (auto begin{ u32{} }; begin < count; begin += batchSize)
+        {
+            auto const end{ std::min(begin + batchSize, count) };
+            this->schedule(counter, [function, begin, end]{ function(begin, end); });
+        }
+    }
+
+    // Runs queued jobs on the calling thread until the counter drains instead of blocking.
+    auto wait(Counter& counter) -> void
+    {
+        auto const owned{ t_owner == this };
+        auto const home { owned ? t_queue : 0u };
+
+        while (!counter.done())
+        {
+            if (!this->tryRun(home, owned))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    inline auto getWorkerCount() const noexcept -> u32
+    {
+        return static_cast<u32>(m.workers.size());
+    }
+
+    static inline auto defaultWorkerCount() noexcept -> u32
+    {
+        auto const hardware{ std::thread::hardware_concurrency() };
+        return hardware > 1 ? hardware - 1 : 1;
+    }
+
+private:
+    struct Entry
+    {
+        Job      job;
+        Counter* counter;
+    };
+
+    struct Queue
+    {
+        std::mutex        mutex;
+        std::deque<Entry> jobs;
+    };
+
+    auto homeQueue() noexcept -> u32
+    {
+        if (t_owner == this)
+        {
+            return t_queue;
+        }
+
+        return m.nextQueue.fetch_add(1, std::memory_order_relaxed) % m.queueCount;
+    }
+
+    auto tryRun(u32 home, bool owned) -> bool
+    {
+        auto entry{ Entry{} };
+
+        if (owned)
+        {
+            auto& queue{ m.queues[home] };
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                entry = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+            }
+        }
+
+        for (auto i{ u32{ owned } }; !entry.counter && i < m.queueCount; ++i)
+        {
+            auto& queue{ m.queues[(home + i) % m.queueCount] };
+            std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+
+            if (lock.owns_lock() && !queue.jobs.empty())
+            {
+                entry = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+            }
+        }
+
+        if (!entry.counter && owned)
+        {
+            std::unique_lock<std::mutex> lock(m.background.mutex, std::try_to_lock);
+
+            if (lock.owns_lock() && !m.background.jobs.empty())
+            {
+                entry = std::move(m.background.jobs.front());
+                m.background.jobs.pop_front();
+            }
+        }
+
+        if (!entry.counter)
+        {
+            return false;
+        }
+
+        m.pending.fetch_sub(1);
+        entry.job();
+        entry.counter->m.value.fetch_sub(1, std::memory_order_release);
+
+        return true;
+    }
+
+    auto workerLoop(u32 index) -> void
+    {
+        t_owner = this;
+        t_queue = index;
+
+        LF_PROFILE_THREAD("Worker " + std::to_string(index));
+
+        while (true)
+        {
+            if (this->tryRun(index, true))
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m.sleepMutex);
+            m.sleepers.fetch_add(1);
+            m.sleepCondition.wait(lock, [this]{ return m.pending.load() > 0 || !m.running.load(); });
+            m.sleepers.fetch_sub(1);
+
+            if (!m.running.load() && m.pending.load() <= 0)
+            {
+                break;
+            }
+        }
+    }
+
+private:
+    static inline thread_local JobSystem* t_owner{ nullptr };
+    static inline thread_local u32        t_queue{ 0 };
+
+    struct M
+    {
+        std::vector<std::thread> workers;
+        std::unique_ptr<Queue[]> queues;
+        Queue                    background;
+        u32                      queueCount;
+        std::atomic<i32>         pending{ 0 };
+        std::atomic<u32>         sleepers{ 0 };
+        std::atomic<u32>         nextQueue{ 0 };
+        std::atomic<bool>        running{ true };
+        std::mutex               sleepMutex;
+        std::condition_variable  sleepCondition;
+    } m;
+};
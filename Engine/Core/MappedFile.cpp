@@ -0,0 +1,124 @@
+#include "MappedFile.hpp"
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : m{}
+{}
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(std::string_view path)
+    : m{}
+{
+    m.file = CreateFileA(std::string{ path }.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (m.file == INVALID_HANDLE_VALUE)
+    {
+        m.file = nullptr;
+        return;
+    }
+
+    auto size{ LARGE_INTEGER{} };
+
+    if (!GetFileSizeEx(m.file, &size) || size.QuadPart == 0)
+    {
+        return;
+    }
+
+    m.mapping = CreateFileMappingA(m.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (!m.mapping)
+    {
+        return;
+    }
+
+    m.data = static_cast<u8 const*>(MapViewOfFile(m.mapping, FILE_MAP_READ, 0, 0, 0));
+    m.size = m.data ? static_cast<size_t>(size.QuadPart) : 0;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m.data)
+    {
+        UnmapViewOfFile(m.data);
+    }
+
+    if (m.mapping)
+    {
+        CloseHandle(m.mapping);
+    }
+
+    if (m.file)
+    {
+        CloseHandle(m.file);
+    }
+
+    m = {};
+}
+
+#else
+
+MappedFile::MappedFile(std::string_view path)
+    : m{}
+{
+    auto const file{ open(std::string{ path }.c_str(), O_RDONLY) };
+
+    if (file < 0)
+    {
+        return;
+    }
+
+    struct stat status{};
+
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        auto const data{ mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0) };
+
+        if (data != MAP_FAILED)
+        {
+            m.data = static_cast<u8 const*>(data);
+            m.size = static_cast<size_t>(status.st_size);
+        }
+    }
+
+    // The mapping keeps its own reference to the file.
+    close(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m.data)
+    {
+        munmap(const_cast<u8*>(m.data), m.size);
+    }
+
+    m = {};
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile&& other)
+    : m{ std::move(other.m) }
+{
+    other.m = {};
+}
+
+// Swapping hands the current mapping to other, which releases it when it is destroyed.
+auto MappedFile::operator=(MappedFile&& other) -> MappedFile&
+{
+    std::swap(m, other.m);
+
+    return *this;
+}
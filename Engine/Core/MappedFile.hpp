@@ -0,0 +1,43 @@
+#pragma once
+#include "Types.hpp"
+#include <string_view>
+
+// Read-only view of a whole file. An empty file or one that cannot be opened maps to nothing.
+class MappedFile
+{
+public:
+    MappedFile();
+    MappedFile(std::string_view path);
+    ~MappedFile();
+    MappedFile(MappedFile const&) = delete;
+    MappedFile(MappedFile&& other);
+    auto operator=(MappedFile const&)  -> MappedFile& = delete;
+    auto operator=(MappedFile&& other) -> MappedFile&;
+
+public:
+    inline auto getData() const noexcept -> u8 const*
+    {
+        return m.data;
+    }
+
+    inline auto getSize() const noexcept -> size_t
+    {
+        return m.size;
+    }
+
+    inline explicit operator bool() const noexcept
+    {
+        return m.data;
+    }
+
+private:
+    struct M
+    {
+        u8 const* data;
+        size_t    size;
+#if defined(_WIN32)
+        void*     file;
+        void*     mapping;
+#endif
+    } m;
+};
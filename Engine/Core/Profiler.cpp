@@ -0,0 +1,197 @@
+#include "Profiler.hpp"
+#include <spdlog/fmt/fmt.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace prof
+{
+    struct Registry
+    {
+        std::mutex                               mutex;
+        std::vector<std::unique_ptr<ThreadRing>> rings;
+        std::atomic<u64>                         frameBegin;
+        std::atomic<u64>                         frameEnd;
+    };
+
+    // Rings are never freed before exit so zones of finished threads can still be exported.
+    static auto registry() -> Registry&
+    {
+        static auto instance{ Registry{} };
+        return instance;
+    }
+
+    // Zone and thread names are arbitrary strings; quotes, backslashes and control characters
+    // would otherwise break the trace.
+    static auto escapeJson(std::string_view text) -> std::string
+    {
+        auto escaped{ std::string{} };
+        escaped.reserve(text.size());
+
+        for (auto const c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                escaped += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+
+        return escaped;
+    }
+}
+
+auto prof::ThreadRing::copy(u64 begin, u64 end, std::pmr::vector<ZoneRecord>& zones) const -> void
+{
+    auto const head { m.head.load(std::memory_order_acquire) };
+    auto const first{ head > capacity ? head - capacity : 0 };
+
+    for (auto i{ first }; i < head; ++i)
+    {
+        auto const record{ m.records[i & (capacity - 1)] };
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // The owning thread may have lapped this slot while it was being read.
+        if (m.head.load(std::memory_order_relaxed) >= i + capacity)
+        {
+            continue;
+        }
+
+        if (record.end >= begin && record.begin <= end)
+        {
+            zones.emplace_back(record);
+        }
+    }
+}
+
+auto prof::registerThread() -> ThreadRing&
+{
+    auto& registry{ prof::registry() };
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    registry.rings.emplace_back(std::make_unique<ThreadRing>(static_cast<u32>(registry.rings.size())));
+    t_ring = registry.rings.back().get();
+
+    return *t_ring;
+}
+
+auto prof::setThreadName(std::string_view name) -> void
+{
+    auto& ring{ threadRing() };
+    std::lock_guard<std::mutex> lock(registry().mutex);
+
+    ring.m.name = name;
+}
+
+auto prof::getThreadName(u32 thread) -> std::string
+{
+    auto& registry{ prof::registry() };
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    if (thread >= registry.rings.size() || registry.rings[thread]->m.name.empty())
+    {
+        return fmt::format("Thread {}", thread);
+    }
+
+    return registry.rings[thread]->m.name;
+}
+
+auto prof::getThreadCount() -> u32
+{
+    auto& registry{ prof::registry() };
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    return static_cast<u32>(registry.rings.size());
+}
+
+auto prof::markFrame() -> void
+{
+    auto& registry{ prof::registry() };
+    auto const time{ now() };
+
+    registry.frameBegin.store(registry.frameEnd.exchange(time, std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+auto prof::getLastFrame() -> FrameRange
+{
+    auto& registry{ prof::registry() };
+
+    return {
+        .begin = registry.frameBegin.load(std::memory_order_relaxed),
+        .end = registry.frameEnd.load(std::memory_order_relaxed)
+    };
+}
+
+auto prof::capture(u64 begin, u64 end, std::pmr::vector<ZoneRecord>& zones) -> void
+{
+    auto& registry{ prof::registry() };
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (auto const& ring : registry.rings)
+    {
+        ring->copy(begin, end, zones);
+    }
+}
+
+// Chrome trace event format with complete ("X") events, loadable in chrome://tracing and Perfetto.
+auto prof::exportChromeTrace(std::string_view path) -> void
+{
+    auto zones{ std::pmr::vector<ZoneRecord>{} };
+    capture(0, std::numeric_limits<u64>::max(), zones);
+
+    auto file{ std::ofstream{ std::string{ path }, std::ios::trunc } };
+
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open trace file: " + std::string{ path });
+    }
+
+    auto origin{ std::numeric_limits<u64>::max() };
+
+    for (auto const& zone : zones)
+    {
+        origin = std::min(origin, zone.begin);
+    }
+
+    auto out{ std::ostreambuf_iterator<char>{ file } };
+
+    fmt::format_to(out, "{{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    for (auto thread{ u32{} }, count{ getThreadCount() }; thread < count; ++thread)
+    {
+        fmt::format_to(
+            out,
+            "{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+            thread ? "," : "",
+            thread,
+            escapeJson(getThreadName(thread))
+        );
+    }
+
+    for (auto const& zone : zones)
+    {
+        fmt::format_to(
+            out,
+            ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+            escapeJson(zone.name),
+            zone.thread,
+            static_cast<f64>(zone.begin - origin) / 1000.0,
+            static_cast<f64>(zone.end - zone.begin) / 1000.0
+        );
+    }
+
+    fmt::format_to(out, "]}}\n");
+}
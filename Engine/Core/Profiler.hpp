@@ -0,0 +1,168 @@
+#pragma once
+#include "Types.hpp"
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace prof
+{
+    struct ZoneRecord
+    {
+        char const* name;
+        u64         begin;
+        u64         end;
+        u32         depth;
+        u32         thread;
+    };
+
+    struct FrameRange
+    {
+        u64 begin;
+        u64 end;
+    };
+
+    inline auto now() noexcept -> u64
+    {
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count());
+    }
+
+    // Completed zones of one thread. Only the owning thread writes, so recording is a store and
+    // a release of the head; readers validate every copied slot against the head like a seqlock.
+    class ThreadRing
+    {
+    public:
+        static constexpr auto capacity{ u64{ 1 } << 14 };
+
+    public:
+        ThreadRing(u32 index)
+            : m{ .index = index }
+        {}
+
+        ~ThreadRing() = default;
+        ThreadRing(ThreadRing const&) = delete;
+        ThreadRing(ThreadRing&&) = delete;
+        auto operator=(ThreadRing const&) -> ThreadRing& = delete;
+        auto operator=(ThreadRing&&) -> ThreadRing& = delete;
+
+    public:
+        inline auto enter() noexcept -> u32
+        {
+            return m.depth++;
+        }
+
+        inline auto leave(char const* name, u64 begin, u32 depth) noexcept -> void
+        {
+            auto const head{ m.head.load(std::memory_order_relaxed) };
+
+            m.records[head & (capacity - 1)] = ZoneRecord{
+                .name = name,
+                .begin = begin,
+                .end = now(),
+                .depth = depth,
+                .thread = m.index
+            };
+
+            m.head.store(head + 1, std::memory_order_release);
+            --m.depth;
+        }
+
+        auto copy(u64 begin, u64 end, std::pmr::vector<ZoneRecord>& zones) const -> void;
+
+    private:
+        friend auto setThreadName(std::string_view name) -> void;
+        friend auto getThreadName(u32 thread) -> std::string;
+
+        struct M
+        {
+            std::array<ZoneRecord, capacity> records;
+            std::atomic<u64>                 head;
+            std::string                      name;
+            u32                              index;
+            u32                              depth;
+        } m;
+    };
+
+    inline std::atomic<bool> g_enabled{ true };
+    inline thread_local ThreadRing* t_ring{ nullptr };
+
+    auto registerThread() -> ThreadRing&;
+    auto setThreadName(std::string_view name) -> void;
+    auto getThreadName(u32 thread) -> std::string;
+    auto getThreadCount() -> u32;
+    auto markFrame() -> void;
+    auto getLastFrame() -> FrameRange;
+    auto capture(u64 begin, u64 end, std::pmr::vector<ZoneRecord>& zones) -> void;
+    auto exportChromeTrace(std::string_view path) -> void;
+
+    inline auto setEnabled(bool enabled) noexcept -> void
+    {
+        g_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    inline auto isEnabled() noexcept -> bool
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    inline auto threadRing() -> ThreadRing&
+    {
+        return t_ring ? *t_ring : registerThread();
+    }
+
+    // Records the enclosing scope on the calling thread. Name must outlive the profiler,
+    // which in practice means a string literal.
+    class Zone
+    {
+    public:
+        explicit Zone(char const* name)
+            : m{ .name = name }
+        {
+            if (isEnabled()) [[likely]]
+            {
+                m.ring = &threadRing();
+                m.depth = m.ring->enter();
+                m.begin = now();
+            }
+        }
+
+        ~Zone()
+        {
+            if (m.ring)
+            {
+                m.ring->leave(m.name, m.begin, m.depth);
+            }
+        }
+
+        Zone(Zone const&) = delete;
+        Zone(Zone&&) = delete;
+        auto operator=(Zone const&) -> Zone& = delete;
+        auto operator=(Zone&&) -> Zone& = delete;
+
+    private:
+        struct M
+        {
+            char const* name;
+            ThreadRing* ring;
+            u64         begin;
+            u32         depth;
+        } m;
+    };
+}
+
+#if defined(LF_PROFILER)
+#   define LF_PROFILE_CONCAT_IMPL(a, b) a##b
+#   define LF_PROFILE_CONCAT(a, b) LF_PROFILE_CONCAT_IMPL(a, b)
+#   define LF_PROFILE_ZONE(name) ::prof::Zone LF_PROFILE_CONCAT(profileZone, __LINE__){ name }
+#   define LF_PROFILE_FRAME() ::prof::markFrame()
+#   define LF_PROFILE_THREAD(name) ::prof::setThreadName(name)
+#else
+#   define LF_PROFILE_ZONE(name)
+#   define LF_PROFILE_FRAME()
+#   define LF_PROFILE_THREAD(name)
+#endif
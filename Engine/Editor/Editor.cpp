@@ -2,11 +2,15 @@
 
 Editor::Editor(Renderer& renderer)
     : m{
-        .viewport = Viewport{ renderer }
+        .viewport = Viewport{ renderer },
+        .profilerView = ProfilerView{ renderer },
+        .rendererView = RendererView{ renderer }
     }
 {}
 
 auto Editor::render() -> void
 {
     m.viewport.render();
+    m.profilerView.render();
+    m.rendererView.render();
 }
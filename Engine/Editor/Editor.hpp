@@ -1,5 +1,7 @@
 #pragma once
 #include "Viewport.hpp"
+#include "ProfilerView.hpp"
+#include "RendererView.hpp"
 
 class Renderer;
 
@@ -19,6 +21,8 @@ public:
 private:
     struct M
     {
-        Viewport viewport;
+        Viewport     viewport;
+        ProfilerView profilerView;
+        RendererView rendererView;
     } m;  
 };
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "ProfilerView.hpp"
+#include "Renderer.hpp"
+#include "BufferResource.hpp"
+#include <spdlog/spdlog.h>
+#include <imgui.h>
+#include <algorithm>
+#include <stdexcept>
+
+ProfilerView::ProfilerView(Renderer& renderer)
+    : m{
+        .renderer = renderer
+    }
+{}
+
+auto ProfilerView::render() -> void
+{
+    if (!ImGui::Begin("Profiler"))
+    {
+        ImGui::End();
+        return;
+    }
+
+    auto enabled{ prof::isEnabled() };
+
+    if (ImGui::Checkbox("Enabled", &enabled))
+    {
+        prof::setEnabled(enabled);
+    }
+
+    ImGui::SameLine();
+    ImGui::Checkbox("Paused", &m.paused);
+    ImGui::SameLine();
+
+    if (ImGui::Button("Export trace"))
+    {
+        try
+        {
+            prof::exportChromeTrace("profile.json");
+            spdlog::info("Exported profiler trace [ path: {} ]", "profile.json");
+        }
+        catch (std::exception const& exception)
+        {
+            spdlog::warn("{}", exception.what());
+        }
+    }
+
+    // Zones are captured again every frame into the frame arena. While paused, the frozen range
+    // stays complete until the threads' rings wrap around it.
+    if (!m.paused)
+    {
+        m.frame = prof::getLastFrame();
+    }
+
+    auto zones{ std::pmr::vector<prof::ZoneRecord>{ &pmr::g_frameArena } };
+
+    if (m.frame.begin)
+    {
+        prof::capture(m.frame.begin, m.frame.end, zones);
+    }
+
+    this->renderGpuZones();
+
+    auto const duration{ static_cast<f64>(m.frame.end - m.frame.begin) };
+    ImGui::Text("CPU frame: %.3f ms", duration / 1e6);
+
+    if (zones.empty() || duration <= 0.0)
+    {
+        ImGui::End();
+        return;
+    }
+
+    constexpr auto rowHeight{ 18.f };
+
+    auto const threadCount{ prof::getThreadCount() };
+    auto* drawList{ ImGui::GetWindowDrawList() };
+    auto const origin{ ImGui::GetCursorScreenPos() };
+    auto const width { std::max(ImGui::GetContentRegionAvail().x, 1.f) };
+    auto const scale { static_cast<f64>(width) / duration };
+
+    auto laneOffset{ 0.f };
+
+    for (auto thread{ u32{} }; thread < threadCount; ++thread)
+    {
+        auto depth{ u32{} };
+        auto used { false };
+
+        for (auto const& zone : zones)
+        {
+            if (zone.thread == thread)
+            {
+                depth = std::max(depth, zone.depth + 1);
+                used = true;
+            }
+        }
+
+        if (!used)
+        {
+            continue;
+        }
+
+        drawList->AddText({ origin.x, origin.y + laneOffset }, ImGui::GetColorU32(ImGuiCol_Text), prof::getThreadName(thread).c_str());
+        laneOffset += rowHeight;
+
+        for (auto const& zone : zones)
+        {
+            if (zone.thread != thread)
+            {
+                continue;
+            }
+
+            auto const begin{ std::max(zone.begin, m.frame.begin) - m.frame.begin };
+            auto const end  { std::min(zone.end,   m.frame.end)   - m.frame.begin };
+
+            auto const min{ ImVec2{
+                origin.x + static_cast<f32>(static_cast<f64>(begin) * scale),
+                origin.y + laneOffset + static_cast<f32>(zone.depth) * rowHeight
+            }};
+
+            auto const max{ ImVec2{
+                std::max(origin.x + static_cast<f32>(static_cast<f64>(end) * scale), min.x + 1.f),
+                min.y + rowHeight - 1.f
+            }};
+
+            auto const hue{ static_cast<f32>(reinterpret_cast<uintptr_t>(zone.name) % 97) / 97.f };
+            drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.5f, 0.8f));
+
+            if (max.x - min.x > ImGui::CalcTextSize(zone.name).x + 4.f)
+            {
+                drawList->AddText({ min.x + 2.f, min.y + 1.f }, IM_COL32_BLACK, zone.name);
+            }
+
+            if (ImGui::IsMouseHoveringRect(min, max))
+            {
+                ImGui::SetTooltip("%s\n%.3f ms", zone.name, static_cast<f64>(zone.end - zone.begin) / 1e6);
+            }
+        }
+
+        laneOffset += static_cast<f32>(depth) * rowHeight;
+    }
+
+    ImGui::Dummy({ width, laneOffset });
+    ImGui::End();
+}
+
+auto ProfilerView::renderGpuZones() -> void
+{
+    auto const& profiler{ m.renderer.getDevice().getGpuProfiler() };
+    auto const columns  { profiler.hasPipelineStatistics() ? 5 : 2 };
+
+    if (profiler.getZones().empty() || !ImGui::BeginTable("GPU zones", columns, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchProp))
+    {
+        return;
+    }
+
+    ImGui::TableSetupColumn("GPU pass");
+    ImGui::TableSetupColumn("Time (ms)");
+
+    if (profiler.hasPipelineStatistics())
+    {
+        ImGui::TableSetupColumn("Vertex invocations");
+        ImGui::TableSetupColumn("Clipping (out / in)");
+        ImGui::TableSetupColumn("Fragment invocations");
+    }
+
+    ImGui::TableHeadersRow();
+
+    for (auto const& zone : profiler.getZones())
+    {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(zone.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", zone.milliseconds);
+
+        if (profiler.hasPipelineStatistics())
+        {
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(zone.vertexInvocations));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu / %llu", static_cast<unsigned long long>(zone.clippingPrimitives), static_cast<unsigned long long>(zone.clippingInvocations));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(zone.fragmentInvocations));
+        }
+    }
+
+    ImGui::EndTable();
+}
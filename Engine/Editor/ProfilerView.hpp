@@ -0,0 +1,32 @@
+#pragma once
+#include "Types.hpp"
+#include "Profiler.hpp"
+
+class Renderer;
+
+// Flame view of the last completed frame, one lane per thread, with nesting drawn as rows,
+// followed by the GPU pass timings and pipeline statistics read back by the device.
+class ProfilerView
+{
+public:
+    ProfilerView(Renderer& renderer);
+    ~ProfilerView() = default;
+    ProfilerView(ProfilerView const&) = delete;
+    ProfilerView(ProfilerView&&) = delete;
+    auto operator=(ProfilerView const&) -> ProfilerView& = delete;
+    auto operator=(ProfilerView&&) -> ProfilerView& = delete;
+
+public:
+    auto render() -> void;
+
+private:
+    auto renderGpuZones() -> void;
+
+private:
+    struct M
+    {
+        Renderer&        renderer;
+        prof::FrameRange frame;
+        bool             paused;
+    } m;
+};
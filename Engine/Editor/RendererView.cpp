@@ -0,0 +1,63 @@
+#include "RendererView.hpp"
+#include "Renderer.hpp"
+#include <imgui.h>
+#include <array>
+
+RendererView::RendererView(Renderer& renderer)
+    : m{
+        .renderer = renderer
+    }
+{}
+
+auto RendererView::render() -> void
+{
+    if (!ImGui::Begin("Renderer"))
+    {
+        ImGui::End();
+        return;
+    }
+
+    constexpr auto pathNames{ std::array{ "Indirect", "Meshlets (compute culling)", "Meshlets (mesh shading)" } };
+
+    auto const currentPath{ m.renderer.getGeometryPath() };
+
+    if (ImGui::BeginCombo("Geometry path", pathNames[static_cast<u32>(currentPath)]))
+    {
+        for (auto path{ u32{} }; path < pathNames.size(); ++path)
+        {
+            auto const geometryPath{ static_cast<Renderer::GeometryPath>(path) };
+
+            if (geometryPath == Renderer::GeometryPath::eMeshShader && !m.renderer.getDevice().hasMeshShader())
+            {
+                continue;
+            }
+
+            if (ImGui::Selectable(pathNames[path], geometryPath == currentPath))
+            {
+                m.renderer.setGeometryPath(geometryPath);
+            }
+        }
+
+        ImGui::EndCombo();
+    }
+
+    // Instances, culling statistics and LOD selection only apply to the indirect path.
+    if (currentPath != Renderer::GeometryPath::eIndirect)
+    {
+        ImGui::End();
+        return;
+    }
+
+    auto lodErrorPixels{ m.renderer.getLodErrorPixels() };
+
+    if (ImGui::SliderFloat("LOD error (px)", &lodErrorPixels, 0.f, 16.f, "%.2f"))
+    {
+        m.renderer.setLodErrorPixels(lodErrorPixels);
+    }
+
+    ImGui::Text("Instances: %u", m.renderer.getTransforms().size());
+    ImGui::Text("Visible instances: %u", m.renderer.getVisibleInstanceCount());
+    ImGui::Text("Drawn triangles: %llu", static_cast<unsigned long long>(m.renderer.getDrawnTriangleCount()));
+
+    ImGui::End();
+}
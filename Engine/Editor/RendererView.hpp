@@ -0,0 +1,25 @@
+#pragma once
+#include "Types.hpp"
+
+class Renderer;
+
+// Renderer settings that can change at runtime, next to the draw statistics they affect.
+class RendererView
+{
+public:
+    RendererView(Renderer& renderer);
+    ~RendererView() = default;
+    RendererView(RendererView const&) = delete;
+    RendererView(RendererView&&) = delete;
+    auto operator=(RendererView const&) -> RendererView& = delete;
+    auto operator=(RendererView&&) -> RendererView& = delete;
+
+public:
+    auto render() -> void;
+
+private:
+    struct M
+    {
+        Renderer& renderer;
+    } m;
+};
@@ -4,7 +4,10 @@
 #include "Window.hpp"
 #include "Renderer.hpp"
 #include "Editor.hpp"
+#include "Profiler.hpp"
+#include <spdlog/spdlog.h>
 #include <string_view>
+#include <charconv>
 #include <memory>
 
 namespace lf
@@ -33,8 +36,13 @@ namespace lf
             auto time{ f32{} };
             auto fps{ u32{} };
 
+            LF_PROFILE_THREAD("Main");
+
             while (m.window.available()) [[likely]]
             {
+                LF_PROFILE_FRAME();
+                LF_PROFILE_ZONE("Engine::execute");
+
                 if (time <= 1)
                 {
                     time += m.window.getDeltaTime();
@@ -42,7 +50,10 @@ namespace lf
                 }
                 else 
                 {
-                    m.window.setTitle(std::to_string(fps));
+                    auto title{ std::array<char, 16>{} };
+                    auto const result{ std::to_chars(title.data(), title.data() + title.size(), fps) };
+
+                    m.window.setTitle(std::string_view{ title.data(), result.ptr });
                     time = 0;
                     fps = 0;
                 }
@@ -50,10 +61,16 @@ namespace lf
                 m.renderer.renderFrame();
                 m.window.update();
                 m.editor.render();
+
+                pmr::g_frameArena.reset();
             }
 
             m.renderer.waitIdle();
 
+            logArenaStats("Frame arena", pmr::g_frameArena.getStats());
+            logArenaStats("Persistent arena", pmr::g_persistentArena.getStats());
+            logArenaStats("Scratch arena", pmr::scratch().getStats());
+
             for (auto& script : m.scripts)
             {
                 script.second->onQuit();
@@ -64,7 +81,20 @@ namespace lf
         template<typename ScriptClass>
         auto registerScript(std::string_view name)
         {
-            m.scripts[std::pmr::string{name.data(), &pmr::g_rsrc}] = std::make_unique<ScriptClass>();
+            m.scripts[std::pmr::string{name.data(), &pmr::g_persistentArena}] = std::make_unique<ScriptClass>();
+        }
+
+    private:
+        static auto logArenaStats(std::string_view name, pmr::ArenaStats const& stats) -> void
+        {
+            spdlog::info(
+                "{} [ high water: {} / {} bytes; overflows: {}; overflow bytes: {} ]",
+                name,
+                stats.highWater,
+                stats.capacity,
+                stats.overflowCount,
+                stats.overflowBytes
+            );
         }
 
     private:
@@ -75,7 +105,7 @@ namespace lf
             Window    window   = Window{ };
             Renderer  renderer = Renderer{ window };
             Editor    editor   = Editor{ renderer };
-            ScriptMap scripts  = ScriptMap{ &pmr::g_rsrc };
+            ScriptMap scripts  = ScriptMap{ &pmr::g_persistentArena };
         } m;
     };
 }
\ No newline at end of file
@@ -1,40 +1,72 @@
 #include "Renderer.hpp"
 #include "Pipeline.hpp"
 #include "Window.hpp"
+#include "Profiler.hpp"
 #include <spdlog/spdlog.h>
 #include <backends/imgui_impl_sdl3.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
 
-Renderer::Renderer(Window& window)
+Renderer::Renderer(Window& window, u32 framesInFlight)
     : m{
-        .window = window,
+        .window = &window,
         .instance = vk::Instance{ true },
         .surface = vk::Surface{ window, m.instance },
         .physicalDevice = vk::PhysicalDevice{ m.instance },
-        .device = vk::Device{ m.instance, m.surface, m.physicalDevice }
+        .device = vk::Device{ m.instance, m.surface, m.physicalDevice, framesInFlight }
     }
 {
-    this->loadModel("Assets/Models/kitten.obj");
+    this->initialize();
 
-    this->initImgui();
-    this->allocateResources();
-    this->createPipelines();
-    this->recordCommandsEmpty();
+    spdlog::info("Created renderer");
+}
 
-    ImGui_ImplSDL3_NewFrame();
-    ImGui::NewFrame();
-    ImGui::DockSpaceOverViewport(ImGui::GetMainViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+// Renders into offscreen targets of the given size; no window, surface or swapchain is created.
+Renderer::Renderer(glm::uvec2 extent, u32 framesInFlight)
+    : m{
+        .instance = vk::Instance{ false, false },
+        .physicalDevice = vk::PhysicalDevice{ m.instance },
+        .device = vk::Device{ m.instance, m.physicalDevice, extent, framesInFlight }
+    }
+{
+    this->initialize();
 
-    spdlog::info("Created renderer");
+    spdlog::info("Created headless renderer");
 }
 
 Renderer::~Renderer()
 {
+    // Imports still queued see the flag and return; running ones finish before the models go.
+    m.streamingCancelled.store(true);
+
+    for (auto& model : m.models)
+    {
+        m.jobs.wait(model->import);
+    }
+
     this->terminateImgui();
     spdlog::info("Destroyed renderer");
 }
 
+auto Renderer::initialize() -> void
+{
+    this->loadModel("Assets/Models/kitten.obj");
+
+    m.geometryPath = GeometryPath::eIndirect;
+
+    this->initImgui();
+    this->allocateResources();
+    this->createPipelines();
+    this->beginImguiFrame();
+}
+
 auto Renderer::updateBuffers() -> void
 {
+    LF_PROFILE_ZONE("Renderer::updateBuffers");
+
     struct
     {
         glm::mat4 projection, view, projView;
@@ -47,131 +79,528 @@ auto Renderer::updateBuffers() -> void
     m.cameraUniformBuffer.write(&cameraData, sizeof(cameraData));
     m.cameraUniformBuffer.flush(m.cameraUniformBuffer.getSize());
 
+    this->updateInstances();
+
     ImGui::ShowDemoWindow();
+    ImGui::Render();
+
+    this->packImgui(ImGui::GetDrawData());
+    this->beginImguiFrame();
+}
+
+// Re-packs the instances the store marked dirty. Only new instances rebuild the draws, since each
+// draw reserves a visible slot per instance of its mesh. Every frame slot has its own copy, so
+// each keeps the union of the ranges changed since it was last written and uploads just that the
+// next time it is recorded.
+auto Renderer::updateInstances() -> void
+{
+    LF_PROFILE_ZONE("Renderer::updateInstances");
+
+    auto const [first, end]{ m.transforms.getDirtyRange() };
+
+    if (first != end)
+    {
+        if (m.instances.size() != m.transforms.size())
+        {
+            m.instances.resize(m.transforms.size());
+            m.staleDrawFrames = m.device.getFramesInFlight();
+
+            this->buildDraws();
+        }
+
+        auto const& scales{ m.transforms.getScales() };
+
+        m.transforms.writeRows(&m.instances[first].rows[0][0], sizeof(InstanceData), first, end - first);
+
+        for (auto i{ first }; i < end; ++i)
+        {
+            m.instances[i].mesh = m.instanceMeshes[i];
+            m.instances[i].scale = scales[i];
+        }
+
+        this->updateInstanceBounds(first, end);
+        m.transforms.clearDirty();
+
+        for (auto& range : m.staleInstanceRanges)
+        {
+            range = range[0] == range[1]
+                ? std::array{ first, end }
+                : std::array{ std::min(range[0], first), std::max(range[1], end) };
+        }
+    }
+
+    if (m.staleDrawFrames)
+    {
+        --m.staleDrawFrames;
+
+        auto const drawCount{ static_cast<u32>(m.indirectCommands.size()) };
+        auto const header   { std::array<u32, 4>{ m.index16DrawCount, drawCount - m.index16DrawCount, 0, 0 } };
+        auto const drawsSize{ drawCount * sizeof(vk::DrawIndexedIndirectCommand) };
+
+        m.indirectBuffer.write(header.data(), sizeof(header), 0);
+        m.indirectBuffer.write(m.indirectCommands.data(), drawsSize, visibleDrawOffset);
+        m.indirectBuffer.flush(visibleDrawOffset + drawsSize);
+
+        m.meshDrawBuffer.write(m.meshDraws.data(), m.meshDraws.size() * sizeof(MeshDraw), 0);
+        m.meshDrawBuffer.flush(m.meshDraws.size() * sizeof(MeshDraw));
+    }
 
+    auto& range{ m.staleInstanceRanges[m.device.getFrameIndex()] };
+
+    if (range[0] != range[1])
     {
-        ImGui::Render();
-        auto imDrawData{ ImGui::GetDrawData() };
+        auto const offset{ range[0] * sizeof(InstanceData) };
+        auto const size  { (range[1] - range[0]) * sizeof(InstanceData) };
+
+        m.instanceBuffer.write(&m.instances[range[0]], size, offset);
+        m.instanceBuffer.flush(size, offset);
 
-        auto const vertexBufferSize{ imDrawData->TotalVtxCount * sizeof(ImDrawVert) };
-        auto const indexBufferSize { imDrawData->TotalIdxCount * sizeof(ImDrawIdx)  };
+        range = {};
+    }
+}
 
-        if ((vertexBufferSize != 0) && (indexBufferSize != 0))
+// One draw per mesh and LOD, 16-bit meshes first so each index size is one contiguous range.
+// Every draw reserves a visible slot per instance of its mesh; culling picks one LOD for each
+// visible instance and fills in the slots and the instance count.
+auto Renderer::buildDraws() -> void
+{
+    auto slot{ u32{} };
+
+    auto const appendDraws{ [this, &slot](u32 indexSize){
+        for (auto i{ size_t{} }; i < m.meshes.size(); ++i)
         {
-            auto vtxOffset{ u32{} };
-            auto idxOffset{ u32{} };
+            auto const& mesh{ m.meshes[i] };
+
+            if (mesh.indexSize != indexSize)
+            {
+                continue;
+            }
+
+            auto& draw{ m.meshDraws[i] };
+
+            draw = MeshDraw{
+                .firstDraw = static_cast<u32>(m.indirectCommands.size()),
+                .lodCount = mesh.lodCount
+            };
 
-            for (auto* cmdList : imDrawData->CmdLists)
+            for (auto level{ 0u }; level < mesh.lodCount; ++level)
             {
-                m.imguiVertexBuffer.write(cmdList->VtxBuffer.Data, cmdList->VtxBuffer.Size * sizeof(ImDrawVert), vtxOffset);
-                m.imguiIndexBuffer.write(cmdList->IdxBuffer.Data, cmdList->IdxBuffer.Size * sizeof(ImDrawIdx), idxOffset);
+                draw.lodErrors[level] = mesh.lods[level].error;
 
-                vtxOffset += cmdList->VtxBuffer.Size * sizeof(ImDrawVert);
-                idxOffset += cmdList->IdxBuffer.Size * sizeof(ImDrawIdx);
+                m.indirectCommands.emplace_back(vk::DrawIndexedIndirectCommand{
+                    .indexCount = mesh.lods[level].indexCount,
+                    .instanceCount = 0,
+                    .firstIndex = mesh.lods[level].indexOffset,
+                    .vertexOffset = static_cast<i32>(mesh.vertexOffset),
+                    .firstInstance = slot
+                });
+
+                slot += m.meshInstanceCounts[i];
             }
+        }
+    }};
 
-            m.imguiVertexBuffer.flush(vertexBufferSize);
-            m.imguiIndexBuffer.flush(indexBufferSize);
+    m.indirectCommands.clear();
+    m.meshDraws.resize(m.meshes.size());
+
+    appendDraws(sizeof(u16));
+    m.index16DrawCount = static_cast<u32>(m.indirectCommands.size());
+    appendDraws(sizeof(u32));
+}
+
+// Copies ImGui geometry into the current frame's buffers and writes one indirect draw per ImGui command.
+auto Renderer::packImgui(ImDrawData* imDrawData) -> void
+{
+    auto const vertexBufferSize{ imDrawData->TotalVtxCount * sizeof(ImDrawVert) };
+    auto const indexBufferSize { imDrawData->TotalIdxCount * sizeof(ImDrawIdx)  };
+
+    if ((vertexBufferSize != 0) && (indexBufferSize != 0))
+    {
+        auto vtxOffset{ u32{} };
+        auto idxOffset{ u32{} };
+
+        for (auto* cmdList : imDrawData->CmdLists)
+        {
+            m.imguiVertexBuffer.write(cmdList->VtxBuffer.Data, cmdList->VtxBuffer.Size * sizeof(ImDrawVert), vtxOffset);
+            m.imguiIndexBuffer.write(cmdList->IdxBuffer.Data, cmdList->IdxBuffer.Size * sizeof(ImDrawIdx), idxOffset);
+
+            vtxOffset += cmdList->VtxBuffer.Size * sizeof(ImDrawVert);
+            idxOffset += cmdList->IdxBuffer.Size * sizeof(ImDrawIdx);
         }
 
-        auto vertexOffset{ i32{} };
-        auto indexOffset{ u32{} };
-        auto drawCount{ u32{} };
+        m.imguiVertexBuffer.flush(vertexBufferSize);
+        m.imguiIndexBuffer.flush(indexBufferSize);
+    }
+
+    auto vertexOffset{ i32{} };
+    auto indexOffset{ u32{} };
+    auto drawCount{ u32{} };
 
-        if (imDrawData && imDrawData->CmdListsCount > 0)
+    if (imDrawData && imDrawData->CmdListsCount > 0)
+    {
+        for (auto* cmdList : imDrawData->CmdLists)
         {
-            for (auto* cmdList : imDrawData->CmdLists)
+            for (auto& cmd : cmdList->CmdBuffer)
             {
-                for (auto& cmd : cmdList->CmdBuffer)
-                {
-                    auto const drawCommand{ vk::DrawIndexedIndirectCommand{
-                        .indexCount = cmd.ElemCount,
-                        .instanceCount = 1,
-                        .firstIndex = indexOffset,
-                        .vertexOffset = vertexOffset,
-                        .firstInstance = drawCount
-                    }};
-
-                    m.imguiDrawBuffer.write(&cmd.ClipRect, sizeof(cmd.ClipRect), sizeof(cmd.ClipRect) * drawCount);
-                    m.imguiIndirectBuffer.write(&drawCommand, sizeof(drawCommand), sizeof(u32) + drawCount * sizeof(drawCommand));
-
-                    ++drawCount;
-                    indexOffset += cmd.ElemCount;
-                }
-                vertexOffset += cmdList->VtxBuffer.Size;
+                auto const drawCommand{ vk::DrawIndexedIndirectCommand{
+                    .indexCount = cmd.ElemCount,
+                    .instanceCount = 1,
+                    .firstIndex = indexOffset,
+                    .vertexOffset = vertexOffset,
+                    .firstInstance = drawCount
+                }};
+
+                m.imguiDrawBuffer.write(&cmd.ClipRect, sizeof(cmd.ClipRect), sizeof(cmd.ClipRect) * drawCount);
+                m.imguiIndirectBuffer.write(&drawCommand, sizeof(drawCommand), sizeof(u32) + drawCount * sizeof(drawCommand));
+
+                ++drawCount;
+                indexOffset += cmd.ElemCount;
             }
-
-            m.imguiIndirectBuffer.write(&drawCount, sizeof(drawCount));
-            m.imguiIndirectBuffer.flush(sizeof(u32) + drawCount * sizeof(vk::DrawIndexedIndirectCommand));
+            vertexOffset += cmdList->VtxBuffer.Size;
         }
 
-        ImGui_ImplSDL3_NewFrame();
-        ImGui::NewFrame();
-        ImGui::DockSpaceOverViewport(ImGui::GetMainViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
+        m.imguiIndirectBuffer.write(&drawCount, sizeof(drawCount));
+        m.imguiIndirectBuffer.flush(sizeof(u32) + drawCount * sizeof(vk::DrawIndexedIndirectCommand));
     }
 }
 
-auto Renderer::recordCommandsEmpty() -> void
+// Each pass records into its own secondary buffer, and therefore its own pool, on the job system.
+// Layout transitions stay on the primary buffer, which only stitches the passes together.
+auto Renderer::recordCommands(vk::CommandBuffer& commands) -> void
 {
-    for (auto i{ u32{} }; auto& commands : m.device.getCommandBuffers())
+    LF_PROFILE_ZONE("Renderer::recordCommands");
+
+    auto const frameIndex{ m.device.getFrameIndex() };
+    auto& passes{ m.passCommands[frameIndex] };
+
+    // This slot's fence has been waited on, so the header it copied last time is final.
+    if (m.geometryPath == GeometryPath::eIndirect)
+    {
+        auto header{ std::array<u32, 4>{} };
+
+        m.drawStatsBuffer.read(header.data(), sizeof(header), frameIndex * sizeof(header));
+        m.visibleInstanceCount = header[2];
+        m.drawnTriangleCount = header[3];
+    }
+
+    if (m.staleAttachmentFrames)
     {
-        commands.begin(i);
+        m.postProcessingPipeline.writeImage(m.colorAttachment, 0, vk::DescriptorType::eCombinedImageSampler, frameIndex);
+        m.depthPyramidPipeline.writeImage(m.depthAttachment, vk::ImageLayout::eShaderRead, 0, vk::DescriptorType::eCombinedImageSampler, frameIndex);
+        m.depthPyramidPipeline.writeBuffer(m.depthPyramidBuffer, 1, vk::DescriptorType::eStorageBuffer, frameIndex);
+        m.drawCullPipeline.writeBuffer(m.depthPyramidBuffer, 3, vk::DescriptorType::eStorageBuffer, frameIndex);
+        --m.staleAttachmentFrames;
+    }
+
+    auto counter{ JobSystem::Counter{} };
+
+    m.jobs.schedule(counter, [this, frameIndex, &passes]{
+        LF_PROFILE_ZONE("Record grid pass");
+
+        auto& grid{ passes[eGridPass] };
+
+        grid.beginInherited(frameIndex, m.colorAttachment, &m.depthAttachment);
+        grid.beginZone("Grid");
+        grid.bindPipeline(m.gridPipeline);
+        grid.draw(4);
+        grid.endZone();
+        grid.end();
+    });
+
+    auto const meshletCount{ m.residentMeshletCount };
+    auto const drawCount   { static_cast<u32>(m.indirectCommands.size()) };
+
+    m.jobs.schedule(counter, [this, frameIndex, meshletCount, drawCount, &passes]{
+        LF_PROFILE_ZONE("Record main pass");
+
+        auto& main{ passes[eMainPass] };
+
+        main.beginInherited(frameIndex, m.colorAttachment, &m.depthAttachment);
+        main.beginZone("Main");
+
+        switch (m.geometryPath)
+        {
+        case GeometryPath::eIndirect:
+            main.bindPipeline(m.mainPipeline);
+            main.bindIndexBuffer16(m.meshIndexBuffer);
+            main.drawIndexedIndirectCount(m.visibleDrawBuffer, visibleDrawOffset, 0, m.index16DrawCount);
+            main.bindIndexBuffer32(m.meshIndexBuffer);
+            main.drawIndexedIndirectCount(
+                m.visibleDrawBuffer,
+                visibleDrawOffset + m.index16DrawCount * sizeof(vk::DrawIndexedIndirectCommand),
+                sizeof(u32),
+                drawCount - m.index16DrawCount
+            );
+            break;
+        case GeometryPath::eMeshletCompute:
+            main.bindPipeline(m.meshletPipeline);
+            main.drawIndirectCount(m.meshletDrawBuffer, meshletCount);
+            break;
+        case GeometryPath::eMeshShader:
+            main.bindPipeline(m.meshShaderPipeline);
+            main.pushConstant(&meshletCount, sizeof(meshletCount));
+            main.drawMeshTasks((meshletCount + 31) / 32);
+            break;
+        }
+
+        main.endZone();
+        main.end();
+    });
+
+    m.jobs.schedule(counter, [this, frameIndex, &passes]{
+        LF_PROFILE_ZONE("Record post-processing pass");
+
+        auto& postProcessing{ passes[ePostProcessingPass] };
+
+        postProcessing.beginInheritedPresent(frameIndex);
+        postProcessing.beginZone("Post-processing");
+        postProcessing.bindPipeline(m.postProcessingPipeline);
+        postProcessing.draw(3);
+        postProcessing.endZone();
+        postProcessing.end();
+    });
+
+    m.jobs.schedule(counter, [this, frameIndex, &passes]{
+        LF_PROFILE_ZONE("Record imgui pass");
+
+        auto const viewportSize{ glm::vec2{
+            2.f / static_cast<f32>(m.device.getExtent().x),
+            2.f / static_cast<f32>(m.device.getExtent().y) * -1.f
+        }};
+
+        auto& imgui{ passes[eImguiPass] };
+
+        imgui.beginInheritedPresent(frameIndex);
+        imgui.beginZone("ImGui");
+        imgui.bindPipeline(m.imguiPipeline);
+        imgui.pushConstant(&viewportSize, sizeof(viewportSize));
+        imgui.bindIndexBuffer16(m.imguiIndexBuffer);
+        imgui.drawIndexedIndirectCount(m.imguiIndirectBuffer, 1024);
+        imgui.endZone();
+        imgui.end();
+    });
+
+    // Culling waits for the previous scene, or for this frame's uploads when there are any, as
+    // they may fill in geometry the instances already reference.
+    auto const priorValue{ m.device.signalValue(vk::QueueType::eGraphics) };
+    m.device.getUploader().flush();
+    auto const uploadValue{ m.device.signalValue(vk::QueueType::eGraphics) };
+
+    auto const culling{
+        m.geometryPath == GeometryPath::eIndirect ||
+        (m.geometryPath == GeometryPath::eMeshletCompute && meshletCount)
+    };
+
+    auto cullValue{ u64{} };
+
+    if (culling)
+    {
+        auto& cull{ m.cullCommands[frameIndex] };
+
+        cull.begin(frameIndex);
+
+        if (m.geometryPath == GeometryPath::eIndirect)
+        {
+            this->recordDrawCulling(cull);
+        }
+        else
         {
-            commands.beginPresent();
-            commands.endPresent();
+            this->recordMeshletCulling(cull, meshletCount);
         }
-        commands.end();
 
-        ++i;
+        cull.end();
+
+        // The previous scene is the last reader of the culling outputs and wrote the pyramid.
+        auto const sceneDone{ vk::SemaphoreSubmit{
+            .semaphore = m.device.getTimeline(vk::QueueType::eGraphics),
+            .value = uploadValue != priorValue ? uploadValue : m.sceneValue,
+            .stage = vk::PipelineStage::eAllCommands
+        }};
+
+        cullValue = m.device.submit(vk::QueueType::eCompute, cull, sceneDone);
+    }
+
+    auto& scene{ m.sceneCommands[frameIndex] };
+
+    scene.begin(frameIndex);
+
+    if (m.geometryPath == GeometryPath::eIndirect)
+    {
+        scene.transferOwnership(m.visibleDrawBuffer, vk::QueueType::eCompute, vk::QueueType::eGraphics);
+        scene.transferOwnership(m.visibleInstanceBuffer, vk::QueueType::eCompute, vk::QueueType::eGraphics);
+    }
+    else if (culling)
+    {
+        scene.transferOwnership(m.meshletDrawBuffer, vk::QueueType::eCompute, vk::QueueType::eGraphics);
     }
+
+    scene.barrier(m.colorAttachment, vk::ImageLayout::eColorAttachment);
+    scene.barrier(m.depthAttachment, vk::ImageLayout::eDepthAttachment);
+
+    m.jobs.wait(counter);
+
+    scene.beginRendering(m.colorAttachment, &m.depthAttachment, true);
+    scene.executeCommands({ &passes[eGridPass], &passes[eMainPass] });
+    scene.endRendering();
+
+    scene.barrier(m.colorAttachment, vk::ImageLayout::eShaderRead);
+
+    if (m.geometryPath == GeometryPath::eIndirect)
+    {
+        this->buildDepthPyramid(scene);
+    }
+    else
+    {
+        m.pyramidValid = false;
+    }
+
+    scene.end();
+
+    if (culling)
+    {
+        auto const cullDone{ vk::SemaphoreSubmit{
+            .semaphore = m.device.getTimeline(vk::QueueType::eCompute),
+            .value = cullValue,
+            .stage = vk::PipelineStage::eAllCommands
+        }};
+
+        m.sceneValue = m.device.submit(vk::QueueType::eGraphics, scene, cullDone);
+    }
+    else
+    {
+        m.sceneValue = m.device.submit(vk::QueueType::eGraphics, scene);
+    }
+
+    commands.beginPresent(true);
+    commands.executeCommands({ &passes[ePostProcessingPass], &passes[eImguiPass] });
+    commands.endPresent();
 }
 
-auto Renderer::recordCommands() -> void
+// Resets the draw count and appends a draw for every meshlet that passes the frustum and cone
+// tests. Recorded on the compute queue; the graphics queue acquires the draws before drawing.
+auto Renderer::recordMeshletCulling(vk::CommandBuffer& commands, u32 meshletCount) -> void
 {
-    auto const viewportSize{ glm::vec2{
-        2.f / static_cast<f32>(m.device.getExtent().x),
-        2.f / static_cast<f32>(m.device.getExtent().y) * -1.f
-    }};
+    commands.beginZone("Meshlet culling");
+    commands.fillBuffer(m.meshletDrawBuffer, 0, sizeof(u32));
+    commands.barrier(m.meshletDrawBuffer, vk::PipelineStage::eTransfer, vk::PipelineStage::eComputeShader);
+    commands.bindPipeline(m.meshletCullPipeline);
+    commands.pushConstant(&meshletCount, sizeof(meshletCount));
+    commands.dispatch((meshletCount + 63) / 64);
+    commands.transferOwnership(m.meshletDrawBuffer, vk::QueueType::eCompute, vk::QueueType::eGraphics);
+    commands.endZone();
+}
 
-    for (auto i{ u32{} }; auto& commands : m.device.getCommandBuffers())
+// Tests every instance against the frustum, and against the previous frame's depth pyramid, and
+// appends the survivors to the draw of the LOD they select. The draws are reset by copying this
+// frame's commands, which carry no instances, into visibleDrawBuffer.
+auto Renderer::recordDrawCulling(vk::CommandBuffer& commands) -> void
+{
+    struct
     {
-        commands.begin(i);
-        {
-            commands.barrier(m.colorAttachment, vk::ImageLayout::eColorAttachment);
-            commands.barrier(m.depthAttachment, vk::ImageLayout::eDepthAttachment);
-            commands.beginRendering(m.colorAttachment, &m.depthAttachment);
+        glm::mat4  previousProjView;
+        glm::uvec2 depthSize;
+        u32        instanceCount;
+        u32        levelCount;
+        u32        occlusion;
+        f32        lodErrorPixels;
+    } const constants{
+        .previousProjView = m.pyramidProjView,
+        .depthSize = m.device.getExtent(),
+        .instanceCount = m.transforms.size(),
+        .levelCount = m.pyramidLevelCount,
+        .occlusion = m.pyramidValid,
+        .lodErrorPixels = m.lodErrorPixels
+    };
 
-            commands.bindPipeline(m.gridPipeline);
-            commands.draw(4);
+    auto const drawsSize  { visibleDrawOffset + m.indirectCommands.size() * sizeof(vk::DrawIndexedIndirectCommand) };
+    auto const statsOffset{ m.device.getFrameIndex() * visibleDrawOffset };
 
-            commands.bindPipeline(m.mainPipeline);
-            commands.drawIndirect(m.indirectBuffer, static_cast<u32>(m.indirectCommands.size()));
+    // The previous scene's reads of the draws and visible slots are ordered before this by the
+    // semaphore; their contents are rewritten, so only the pyramid changes hands.
+    commands.beginZone("Draw culling");
 
-            commands.endRendering();
-            commands.barrier(m.colorAttachment, vk::ImageLayout::eShaderRead);
+    if (m.pyramidValid)
+    {
+        commands.transferOwnership(m.depthPyramidBuffer, vk::QueueType::eGraphics, vk::QueueType::eCompute);
+    }
 
-            commands.beginPresent();
+    commands.copyBuffer(m.indirectBuffer, m.visibleDrawBuffer, drawsSize);
+    commands.barrier(
+        m.visibleDrawBuffer,
+        vk::PipelineStage::eTransfer,
+        vk::Access::eTransferWrite,
+        vk::PipelineStage::eComputeShader,
+        vk::Access::eShaderStorageRead | vk::Access::eShaderStorageWrite
+    );
 
-            commands.bindPipeline(m.postProcessingPipeline);
-            commands.draw(3);
+    if (constants.instanceCount)
+    {
+        commands.bindPipeline(m.drawCullPipeline);
+        commands.pushConstant(&constants, sizeof(constants));
+        commands.dispatch((constants.instanceCount + 63) / 64);
+    }
 
-            commands.bindPipeline(m.imguiPipeline);
-            commands.pushConstant(&viewportSize, sizeof(viewportSize));
-            commands.bindIndexBuffer16(m.imguiIndexBuffer);
-            commands.drawIndexedIndirectCount(m.imguiIndirectBuffer, 1024);
+    commands.barrier(
+        m.visibleDrawBuffer,
+        vk::PipelineStage::eComputeShader,
+        vk::Access::eShaderStorageWrite,
+        vk::PipelineStage::eTransfer,
+        vk::Access::eTransferRead
+    );
+
+    commands.copyBuffer(m.visibleDrawBuffer, m.drawStatsBuffer, visibleDrawOffset, 0, statsOffset);
+    commands.barrier(m.drawStatsBuffer, vk::PipelineStage::eTransfer, vk::Access::eTransferWrite, vk::PipelineStage::eHost, vk::Access::eHostRead, statsOffset, visibleDrawOffset);
+    commands.transferOwnership(m.visibleDrawBuffer, vk::QueueType::eCompute, vk::QueueType::eGraphics);
+    commands.transferOwnership(m.visibleInstanceBuffer, vk::QueueType::eCompute, vk::QueueType::eGraphics);
+    commands.endZone();
+}
 
-            commands.endPresent();
-        }
-        commands.end();
+// Max-reduces the depth attachment into a chain of half-size levels, so a single texel of level L
+// bounds the depth of the 2^(L+1) square of pixels it covers. Read by the next frame's culling.
+auto Renderer::buildDepthPyramid(vk::CommandBuffer& commands) -> void
+{
+    struct
+    {
+        glm::uvec2 sourceSize;
+        glm::uvec2 destinationSize;
+        u32        sourceOffset;
+        u32        destinationOffset;
+        u32        level;
+    } constants{
+        .sourceSize = m.device.getExtent()
+    };
 
-        ++i;
+    // This frame's culling read the previous pyramid before the scene's wait on it; the new one is
+    // overwritten in full, so it is released to the next frame's culling without being acquired.
+    commands.beginZone("Depth pyramid");
+    commands.barrier(m.depthAttachment, vk::ImageLayout::eShaderRead);
+    commands.bindPipeline(m.depthPyramidPipeline);
+
+    for (auto level{ 0u }; level < m.pyramidLevelCount; ++level)
+    {
+        constants.destinationSize = (constants.sourceSize + 1u) / 2u;
+        constants.level = level;
+
+        commands.pushConstant(&constants, sizeof(constants));
+        commands.dispatch((constants.destinationSize.x + 7) / 8, (constants.destinationSize.y + 7) / 8);
+        commands.barrier(m.depthPyramidBuffer, vk::PipelineStage::eComputeShader, vk::PipelineStage::eComputeShader);
+
+        constants.sourceOffset = constants.destinationOffset;
+        constants.destinationOffset += constants.destinationSize.x * constants.destinationSize.y;
+        constants.sourceSize = constants.destinationSize;
     }
+
+    commands.transferOwnership(m.depthPyramidBuffer, vk::QueueType::eGraphics, vk::QueueType::eCompute);
+    commands.endZone();
+
+    m.pyramidProjView = m.currentCamera->getProjectionView();
+    m.pyramidValid = true;
 }
 
+// Frames still in flight keep sampling the old attachments and pyramid through their own
+// descriptor sets, so each frame slot picks up the new ones the next time it is recorded.
 auto Renderer::onResize() -> void
 {
-    this->waitIdle();
-
     m.colorAttachment.~Image();
     m.colorAttachment = vk::Image{
         &m.device,
@@ -184,17 +613,38 @@ auto Renderer::onResize() -> void
     m.depthAttachment = vk::Image{
         &m.device,
         m.device.getExtent(),
-        vk::ImageUsage::eDepthAttachment,
+        vk::ImageUsage::eDepthAttachment | vk::ImageUsage::eSampled,
         vk::Format::eD32_sfloat
     };
 
-    m.postProcessingPipeline.writeImage(m.colorAttachment, 0, vk::DescriptorType::eCombinedImageSampler);
+    this->createDepthPyramid();
 
-    this->recordCommands();
+    m.staleAttachmentFrames = m.device.getFramesInFlight();
 }
 
 auto Renderer::allocateResources() -> void
 {
+    m.passCommands.resize(m.device.getFramesInFlight());
+    m.cullCommands.resize(m.device.getFramesInFlight());
+    m.sceneCommands.resize(m.device.getFramesInFlight());
+    m.staleInstanceRanges.resize(m.device.getFramesInFlight());
+
+    for (auto& passes : m.passCommands)
+    {
+        for (auto& pass : passes)
+        {
+            pass.allocate(&m.device, vk::QueueType::eGraphics, vk::CommandBufferLevel::eSecondary);
+        }
+    }
+
+    // Culling runs on the compute queue, and the scene it feeds is submitted apart from the frame
+    // so the next frame's culling only waits for the scene, not for post-processing and present.
+    for (auto frame{ u32{} }; frame < m.device.getFramesInFlight(); ++frame)
+    {
+        m.cullCommands[frame].allocate(&m.device, vk::QueueType::eCompute, vk::CommandBufferLevel::ePrimary);
+        m.sceneCommands[frame].allocate(&m.device, vk::QueueType::eGraphics, vk::CommandBufferLevel::ePrimary);
+    }
+
     m.colorAttachment = vk::Image{ 
         &m.device,
         m.device.getExtent(),
@@ -205,10 +655,12 @@ auto Renderer::allocateResources() -> void
     m.depthAttachment = vk::Image{
         &m.device,
         m.device.getExtent(),
-        vk::ImageUsage::eDepthAttachment,
+        vk::ImageUsage::eDepthAttachment | vk::ImageUsage::eSampled,
         vk::Format::eD32_sfloat
     };
 
+    this->createDepthPyramid();
+
     {
         auto fontData{ static_cast<u8*>(nullptr) };
         auto texWidth{ i32{} }, texHeight{ i32{} };
@@ -226,26 +678,55 @@ auto Renderer::allocateResources() -> void
         m.imguiFontTexture.write(fontData, uploadSize);
     }
 
-    m.indirectBuffer = vk::Buffer{
+    // Geometry buffers are allocated once with room for streamed models; see loadModelAsync.
+    m.reserved = cache::getBases(m.meshLoader);
+    m.residentMeshletCount = m.reserved.meshlet;
+
+    m.capacity = cache::MeshBases{
+        .vertex = std::max(m.reserved.vertex, geometryCapacity.vertex),
+        .indexWord = std::max(m.reserved.indexWord, geometryCapacity.indexWord),
+        .mesh = std::max(m.reserved.mesh, geometryCapacity.mesh),
+        .meshlet = std::max(m.reserved.meshlet, geometryCapacity.meshlet),
+        .meshletVertex = std::max(m.reserved.meshletVertex, geometryCapacity.meshletVertex),
+        .meshletTriangle = std::max(m.reserved.meshletTriangle, geometryCapacity.meshletTriangle)
+    };
+
+    // Header and draws as laid out in visibleDrawBuffer, copied there before culling.
+    m.indirectBuffer = vk::SwapBuffer{
         m.device,
-        static_cast<u32>(sizeof(vk::DrawIndirectCommand) * 1024),
-        vk::BufferUsage::eIndirectBuffer,
-        vk::MemoryType::eDevice
+        static_cast<u32>(visibleDrawOffset + sizeof(vk::DrawIndexedIndirectCommand) * m.capacity.mesh * Mesh::maxLods),
+        vk::BufferUsage::eTransferSrc,
+        vk::MemoryType::eHost
     };
 
-    m.indirectBuffer.write(m.indirectCommands.data(), m.indirectCommands.size() * sizeof(vk::DrawIndirectCommand));
+    m.instanceBuffer = vk::SwapBuffer{
+        m.device,
+        static_cast<u32>(sizeof(InstanceData) * maxInstances),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eHost,
+        vk::SharingMode::eConcurrent
+    };
+
+    m.meshDrawBuffer = vk::SwapBuffer{
+        m.device,
+        static_cast<u32>(sizeof(MeshDraw) * m.capacity.mesh),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eHost,
+        vk::SharingMode::eConcurrent
+    };
 
     m.cameraUniformBuffer = vk::SwapBuffer{
         m.device,
         sizeof(glm::mat4) * 3,
         vk::BufferUsage::eUniformBuffer,
-        vk::MemoryType::eHost
+        vk::MemoryType::eHost,
+        vk::SharingMode::eConcurrent
     };
 
     m.meshIndexBuffer = vk::Buffer{
         m.device,
-        static_cast<u32>(m.meshLoader.indices.size() * sizeof(u32)),
-        vk::BufferUsage::eStorageBuffer,
+        static_cast<u32>(m.capacity.indexWord * sizeof(u32)),
+        vk::BufferUsage::eIndexBuffer,
         vk::MemoryType::eDevice
     };
 
@@ -253,7 +734,7 @@ auto Renderer::allocateResources() -> void
 
     m.meshPositionBuffer = vk::Buffer{
         m.device,
-        static_cast<u32>(m.meshLoader.positions.size() * sizeof(u32)),
+        static_cast<u32>(m.capacity.vertex * 3 * sizeof(u16)),
         vk::BufferUsage::eStorageBuffer,
         vk::MemoryType::eDevice
     };
@@ -262,7 +743,7 @@ auto Renderer::allocateResources() -> void
 
     m.meshCoordsBuffer = vk::Buffer{
         m.device,
-        static_cast<u32>(m.meshLoader.uvs.size() * sizeof(u32)),
+        static_cast<u32>(m.capacity.vertex * 2 * sizeof(u16)),
         vk::BufferUsage::eStorageBuffer,
         vk::MemoryType::eDevice
     };
@@ -271,11 +752,100 @@ auto Renderer::allocateResources() -> void
 
     m.meshNormalBuffer = vk::Buffer{
         m.device,
-        static_cast<u32>(m.meshLoader.normals.size() * sizeof(u32)),
+        static_cast<u32>(m.capacity.vertex * sizeof(u32)),
         vk::BufferUsage::eStorageBuffer,
         vk::MemoryType::eDevice
     };
 
+    m.meshParamsBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(m.capacity.mesh * sizeof(MeshParams)),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eDevice
+    };
+
+    m.meshParamsBuffer.write(m.meshLoader.params.data(), m.meshLoader.params.size() * sizeof(MeshParams));
+
+    m.meshBoundsBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(m.capacity.mesh * sizeof(MeshBounds)),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eDevice,
+        vk::SharingMode::eConcurrent
+    };
+
+    {
+        auto bounds{ std::vector<MeshBounds>{} };
+
+        std::ranges::transform(m.meshes, std::back_inserter(bounds), &Mesh::bounds);
+        m.meshBoundsBuffer.write(bounds.data(), bounds.size() * sizeof(MeshBounds));
+    }
+
+    m.meshletBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(m.capacity.meshlet * sizeof(Meshlet)),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eDevice,
+        vk::SharingMode::eConcurrent
+    };
+
+    m.meshletBuffer.write(m.meshLoader.meshlets.data(), m.meshLoader.meshlets.size() * sizeof(Meshlet));
+
+    m.meshletVertexBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(m.capacity.meshletVertex * sizeof(u32)),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eDevice
+    };
+
+    m.meshletVertexBuffer.write(m.meshLoader.meshletVertices.data(), m.meshLoader.meshletVertices.size() * sizeof(u32));
+
+    m.meshletTriangleBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>((m.capacity.meshletTriangle + 3) & ~u32{ 3 }),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eDevice
+    };
+
+    m.meshletTriangleBuffer.write(m.meshLoader.meshletTriangles.data(), m.meshLoader.meshletTriangles.size());
+
+    // Draw count followed by one draw per meshlet, written by the culling pass every frame.
+    m.meshletDrawBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(sizeof(u32) + m.capacity.meshlet * sizeof(vk::DrawIndirectCommand)),
+        vk::BufferUsage::eStorageBuffer | vk::BufferUsage::eIndirectBuffer | vk::BufferUsage::eTransferDst,
+        vk::MemoryType::eDevice
+    };
+
+    // The draws of every mesh and LOD with the instance counts filled in by culling.
+    m.visibleDrawBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(visibleDrawOffset + m.capacity.mesh * Mesh::maxLods * sizeof(vk::DrawIndexedIndirectCommand)),
+        vk::BufferUsage::eStorageBuffer | vk::BufferUsage::eIndirectBuffer | vk::BufferUsage::eTransferSrc | vk::BufferUsage::eTransferDst,
+        vk::MemoryType::eDevice
+    };
+
+    // Indices of the visible instances, in the slots each draw reserves from firstInstance on.
+    m.visibleInstanceBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(maxInstances * Mesh::maxLods * sizeof(u32)),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eDevice
+    };
+
+    // The visibleDrawBuffer header of every frame slot, read back for the culling statistics.
+    m.drawStatsBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(m.device.getFramesInFlight() * visibleDrawOffset),
+        vk::BufferUsage::eTransferDst,
+        vk::MemoryType::eHostOnly
+    };
+
+    {
+        auto const zeroHeaders{ std::vector<u8>(m.device.getFramesInFlight() * visibleDrawOffset) };
+        m.drawStatsBuffer.write(zeroHeaders.data(), zeroHeaders.size());
+    }
+
     {
         constexpr auto vertexBufferSize  { u32{ 512 * 1024 * sizeof(ImDrawVert)}                     };
         constexpr auto indexBufferSize   { u32{ 512 * 1024 * sizeof(ImDrawIdx)}                      };
@@ -293,6 +863,12 @@ auto Renderer::allocateResources() -> void
     }
 
     m.meshNormalBuffer.write(m.meshLoader.normals.data(), m.meshLoader.normals.size() * sizeof(m.meshLoader.normals[0]));
+
+    m.device.getUploader().flush();
+    m.sceneValue = m.device.signalValue(vk::QueueType::eGraphics);
+
+    // Every stream has been copied into staging memory, so the host copy of the geometry can go.
+    m.meshLoader = MeshLoader{ &m.jobs };
 }
 
 auto Renderer::createPipelines() -> void
@@ -304,11 +880,34 @@ auto Renderer::createPipelines() -> void
             { .stage = vk::ShaderStage::eFragment, .path = "shaders/main.frag.spv" }
         },
         .descriptors = {
-            { 0, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshIndexBuffer },
             { 1, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshPositionBuffer },
             { 2, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshCoordsBuffer },
             { 3, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshNormalBuffer },
-            { 4, vk::ShaderStage::eVertex, vk::DescriptorType::eUniformBuffer, nullptr, &m.cameraUniformBuffer }
+            { 4, vk::ShaderStage::eVertex, vk::DescriptorType::eUniformBuffer, nullptr, &m.cameraUniformBuffer },
+            { 5, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshParamsBuffer },
+            { 6, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, nullptr, &m.instanceBuffer },
+            { 7, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.visibleInstanceBuffer }
+        },
+        .topology = vk::Pipeline::Topology::eTriangleList,
+        .cullMode = vk::Pipeline::CullMode::eBack,
+        .depthWrite = true,
+        .depthTest = true,
+    }};
+
+    m.meshletPipeline = vk::Pipeline{ m.device, vk::Pipeline::Config{
+        .point = vk::Pipeline::BindPoint::eGraphics,
+        .stages = {
+            { .stage = vk::ShaderStage::eVertex,   .path = "shaders/meshlet.vert.spv" },
+            { .stage = vk::ShaderStage::eFragment, .path = "shaders/main.frag.spv" }
+        },
+        .descriptors = {
+            { 0, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshletBuffer },
+            { 1, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshletVertexBuffer },
+            { 2, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshletTriangleBuffer },
+            { 3, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshPositionBuffer },
+            { 4, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshNormalBuffer },
+            { 5, vk::ShaderStage::eVertex, vk::DescriptorType::eUniformBuffer, nullptr, &m.cameraUniformBuffer },
+            { 6, vk::ShaderStage::eVertex, vk::DescriptorType::eStorageBuffer, &m.meshParamsBuffer }
         },
         .topology = vk::Pipeline::Topology::eTriangleList,
         .cullMode = vk::Pipeline::CullMode::eBack,
@@ -316,6 +915,46 @@ auto Renderer::createPipelines() -> void
         .depthTest = true,
     }};
 
+    m.meshletCullPipeline = vk::Pipeline{ m.device, vk::Pipeline::Config{
+        .point = vk::Pipeline::BindPoint::eCompute,
+        .stages = {
+            { .stage = vk::ShaderStage::eCompute, .path = "shaders/meshletCull.comp.spv" }
+        },
+        .descriptors = {
+            { 0, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, &m.meshletBuffer },
+            { 1, vk::ShaderStage::eCompute, vk::DescriptorType::eUniformBuffer, nullptr, &m.cameraUniformBuffer },
+            { 2, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, &m.meshletDrawBuffer }
+        },
+        .usePushConstant = true
+    }};
+
+    if (m.device.hasMeshShader())
+    {
+        constexpr auto taskMesh{ vk::ShaderStage::eTask | vk::ShaderStage::eMesh };
+
+        m.meshShaderPipeline = vk::Pipeline{ m.device, vk::Pipeline::Config{
+            .point = vk::Pipeline::BindPoint::eGraphics,
+            .stages = {
+                { .stage = vk::ShaderStage::eTask,     .path = "shaders/meshlet.task.spv" },
+                { .stage = vk::ShaderStage::eMesh,     .path = "shaders/meshlet.mesh.spv" },
+                { .stage = vk::ShaderStage::eFragment, .path = "shaders/main.frag.spv" }
+            },
+            .descriptors = {
+                { 0, taskMesh,               vk::DescriptorType::eStorageBuffer, &m.meshletBuffer },
+                { 1, vk::ShaderStage::eMesh, vk::DescriptorType::eStorageBuffer, &m.meshletVertexBuffer },
+                { 2, vk::ShaderStage::eMesh, vk::DescriptorType::eStorageBuffer, &m.meshletTriangleBuffer },
+                { 3, vk::ShaderStage::eMesh, vk::DescriptorType::eStorageBuffer, &m.meshPositionBuffer },
+                { 4, vk::ShaderStage::eMesh, vk::DescriptorType::eStorageBuffer, &m.meshNormalBuffer },
+                { 5, taskMesh,               vk::DescriptorType::eUniformBuffer, nullptr, &m.cameraUniformBuffer },
+                { 6, vk::ShaderStage::eMesh, vk::DescriptorType::eStorageBuffer, &m.meshParamsBuffer }
+            },
+            .cullMode = vk::Pipeline::CullMode::eBack,
+            .depthWrite = true,
+            .depthTest = true,
+            .usePushConstant = true
+        }};
+    }
+
     m.gridPipeline = vk::Pipeline{ m.device, vk::Pipeline::Config{
         .point = vk::Pipeline::BindPoint::eGraphics,
         .stages = {
@@ -365,6 +1004,74 @@ auto Renderer::createPipelines() -> void
     }};
 
     m.postProcessingPipeline.writeImage(m.colorAttachment, 0, vk::DescriptorType::eCombinedImageSampler);
+
+    m.depthPyramidPipeline = vk::Pipeline{ m.device, vk::Pipeline::Config{
+        .point = vk::Pipeline::BindPoint::eCompute,
+        .stages = {
+            { .stage = vk::ShaderStage::eCompute, .path = "shaders/depthPyramid.comp.spv" }
+        },
+        .descriptors = {
+            { 0, vk::ShaderStage::eCompute, vk::DescriptorType::eCombinedImageSampler },
+            { 1, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, &m.depthPyramidBuffer }
+        },
+        .usePushConstant = true
+    }};
+
+    // The depth attachment is only moved to the sampled layout when the pyramid is built.
+    for (auto frame{ u32{} }; frame < m.device.getFramesInFlight(); ++frame)
+    {
+        m.depthPyramidPipeline.writeImage(m.depthAttachment, vk::ImageLayout::eShaderRead, 0, vk::DescriptorType::eCombinedImageSampler, frame);
+    }
+
+    m.drawCullPipeline = vk::Pipeline{ m.device, vk::Pipeline::Config{
+        .point = vk::Pipeline::BindPoint::eCompute,
+        .stages = {
+            { .stage = vk::ShaderStage::eCompute, .path = "shaders/drawCull.comp.spv" }
+        },
+        .descriptors = {
+            { 0, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, nullptr, &m.instanceBuffer },
+            { 1, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, &m.meshBoundsBuffer },
+            { 2, vk::ShaderStage::eCompute, vk::DescriptorType::eUniformBuffer, nullptr, &m.cameraUniformBuffer },
+            { 3, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, &m.depthPyramidBuffer },
+            { 4, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, &m.visibleDrawBuffer },
+            { 5, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, nullptr, &m.meshDrawBuffer },
+            { 6, vk::ShaderStage::eCompute, vk::DescriptorType::eStorageBuffer, &m.visibleInstanceBuffer }
+        },
+        .usePushConstant = true
+    }};
+}
+
+// The pyramid depends on the extent, so it is recreated on resize and occlusion culling stays off
+// until a frame has rebuilt it. Each frame slot rebinds it the next time it is recorded.
+auto Renderer::createDepthPyramid() -> void
+{
+    auto levelSize{ (m.device.getExtent() + 1u) / 2u };
+    auto texelCount{ u32{} };
+
+    m.pyramidLevelCount = 0;
+
+    while (true)
+    {
+        texelCount += levelSize.x * levelSize.y;
+        ++m.pyramidLevelCount;
+
+        if (levelSize.x == 1 && levelSize.y == 1)
+        {
+            break;
+        }
+
+        levelSize = (levelSize + 1u) / 2u;
+    }
+
+    m.depthPyramidBuffer.~Buffer();
+    m.depthPyramidBuffer = vk::Buffer{
+        m.device,
+        static_cast<u32>(texelCount * sizeof(f32)),
+        vk::BufferUsage::eStorageBuffer,
+        vk::MemoryType::eDevice
+    };
+
+    m.pyramidValid = false;
 }
 
 auto Renderer::initImgui() -> void
@@ -374,32 +1081,66 @@ auto Renderer::initImgui() -> void
     auto& io{ ImGui::GetIO() }; (void)io;
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
 
-    ImGui_ImplSDL3_InitForVulkan(const_cast<SDL_Window*>(m.window.getHandle()));
+    if (m.window)
+    {
+        ImGui_ImplSDL3_InitForVulkan(const_cast<SDL_Window*>(m.window->getHandle()));
+    }
+}
+
+// Headless frames have no platform backend, so display size and time step are fed by hand.
+auto Renderer::beginImguiFrame() -> void
+{
+    if (m.window)
+    {
+        ImGui_ImplSDL3_NewFrame();
+    }
+    else
+    {
+        auto& io{ ImGui::GetIO() };
+        io.DisplaySize = ImVec2{ static_cast<f32>(m.device.getExtent().x), static_cast<f32>(m.device.getExtent().y) };
+        io.DeltaTime = 1.f / 60.f;
+    }
+
+    ImGui::NewFrame();
+    ImGui::DockSpaceOverViewport(ImGui::GetMainViewport(), ImGuiDockNodeFlags_PassthruCentralNode);
 }
 
 auto Renderer::terminateImgui() -> void
 {
-    ImGui_ImplSDL3_Shutdown();
+    if (m.window)
+    {
+        ImGui_ImplSDL3_Shutdown();
+    }
+
     ImGui::DestroyContext();
 }
 
 auto Renderer::renderFrame() -> void
 {
-    this->updateBuffers();
+    LF_PROFILE_ZONE("Renderer::renderFrame");
 
-    switch (m.device.checkSwapchainState(m.window))
-    {
-    [[likely]]   case vk::Device::SwapchainResult::eSuccess:
-        m.device.submitAndPresent();
-        break;
-    [[unlikely]] case vk::Device::SwapchainResult::eRecreated:
-        this->onResize();
-        m.device.submitAndPresent();
-        break;
-    [[unlikely]] case vk::Device::SwapchainResult::eTerminated:
-        m.device.waitIdle();
-        return;
+    if (m.window)
+    {
+        switch (m.device.checkSwapchainState(*m.window))
+        {
+        [[likely]]   case vk::Device::SwapchainResult::eSuccess:
+            break;
+        [[unlikely]] case vk::Device::SwapchainResult::eRecreated:
+            this->onResize();
+            break;
+        [[unlikely]] case vk::Device::SwapchainResult::eTerminated:
+            m.device.waitIdle();
+            return;
+        }
     }
+
+    auto& commands{ m.device.beginFrame() };
+
+    this->updateStreaming();
+    this->updateBuffers();
+    this->recordCommands(commands);
+
+    m.device.submitAndPresent();
 }
 
 auto Renderer::waitIdle() -> void
@@ -407,19 +1148,289 @@ auto Renderer::waitIdle() -> void
     m.device.waitIdle();
 }
 
+auto Renderer::setGeometryPath(GeometryPath path) -> void
+{
+    if (path == GeometryPath::eMeshShader && !m.device.hasMeshShader())
+    {
+        throw std::runtime_error("Failed to select mesh shading: VK_EXT_mesh_shader is not supported");
+    }
+
+    m.geometryPath = path;
+}
+
+auto Renderer::readback() -> std::vector<u8>
+{
+    return m.device.readback();
+}
+
 auto Renderer::loadModel(std::string_view path) -> void
 {
-    auto meshes{ m.meshLoader.loadMesh(path, false) };
+    this->addMeshes(m.meshLoader.loadMesh(path, false));
+}
 
-    for (auto const& mesh : meshes)
+auto Renderer::loadModelAsync(std::string_view path) -> ModelHandle
+{
+    auto const handle{ static_cast<ModelHandle>(m.models.size()) };
+    auto& model{ *m.models.emplace_back(std::make_unique<StreamedModel>()) };
+
+    model.path = path;
+    model.loader = MeshLoader{ &m.jobs };
+
+    m.jobs.scheduleBackground(model.import, [this, &model]{
+        LF_PROFILE_ZONE("Import streamed model");
+
+        if (m.streamingCancelled.load())
+        {
+            model.state.store(ModelState::eFailed, std::memory_order_release);
+            return;
+        }
+
+        try
+        {
+            model.meshes = model.loader.loadMesh(model.path, false);
+            model.state.store(ModelState::eUploading, std::memory_order_release);
+        }
+        catch (std::exception const& exception)
+        {
+            spdlog::error("Failed to load model [ path: {}; error: {} ]", model.path, exception.what());
+            model.state.store(ModelState::eFailed, std::memory_order_release);
+        }
+    });
+
+    return handle;
+}
+
+auto Renderer::getModelState(ModelHandle handle) const -> ModelState
+{
+    return m.models.at(handle)->state.load(std::memory_order_acquire);
+}
+
+// Models are placed and become resident strictly in request order, so geometry stays
+// contiguous and the resident meshlet count is a prefix of the meshlet buffer.
+auto Renderer::updateStreaming() -> void
+{
+    LF_PROFILE_ZONE("Renderer::updateStreaming");
+
+    while (m.queuedModels < m.models.size())
+    {
+        auto& model{ *m.models[m.queuedModels] };
+        auto const state{ model.state.load(std::memory_order_acquire) };
+
+        if (state == ModelState::eLoading)
+        {
+            break;
+        }
+
+        ++m.queuedModels;
+
+        if (state == ModelState::eUploading)
+        {
+            this->queueUploads(model);
+        }
+    }
+
+    auto budget{ streamingBudget };
+
+    while (budget && !m.pendingUploads.empty())
+    {
+        auto& upload{ m.pendingUploads.front() };
+        auto const size{ std::min(upload.size, budget) };
+
+        upload.model->token = upload.buffer->write(upload.data, size, upload.offset);
+        upload.model->pendingBytes -= size;
+
+        upload.data += size;
+        upload.offset += size;
+        upload.size -= size;
+        budget -= size;
+
+        if (!upload.size)
+        {
+            m.pendingUploads.pop_front();
+        }
+    }
+
+    while (m.residentModels < m.queuedModels)
     {
-        auto instance{ static_cast<u32>(m.indirectCommands.size()) };
+        auto& model{ *m.models[m.residentModels] };
 
-        m.indirectCommands.emplace_back(vk::DrawIndirectCommand{
-            .vertexCount = mesh.indexCount,
-            .instanceCount = 1,
-            .firstVertex = mesh.indexOffset,
-            .firstInstance = instance
+        if (model.state.load(std::memory_order_acquire) == ModelState::eUploading)
+        {
+            if (model.pendingBytes || !m.device.getUploader().poll(model.token))
+            {
+                break;
+            }
+
+            this->makeResident(model);
+        }
+
+        ++m.residentModels;
+    }
+}
+
+// Reserves the model's ranges behind everything placed so far and splits its streams into
+// uploads that updateStreaming writes a bounded number of bytes of per frame.
+auto Renderer::queueUploads(StreamedModel& model) -> void
+{
+    auto const size{ cache::getBases(model.loader) };
+
+    auto const fits{
+        m.reserved.vertex + size.vertex <= m.capacity.vertex &&
+        m.reserved.indexWord + size.indexWord <= m.capacity.indexWord &&
+        m.reserved.mesh + size.mesh <= m.capacity.mesh &&
+        m.reserved.meshlet + size.meshlet <= m.capacity.meshlet &&
+        m.reserved.meshletVertex + size.meshletVertex <= m.capacity.meshletVertex &&
+        m.reserved.meshletTriangle + size.meshletTriangle <= m.capacity.meshletTriangle
+    };
+
+    if (!fits)
+    {
+        spdlog::error("Failed to stream model: geometry capacity exceeded [ path: {} ]", model.path);
+        model.state.store(ModelState::eFailed, std::memory_order_release);
+        return;
+    }
+
+    model.loader.rebase(m.reserved, model.meshes);
+
+    auto const queue{ [this, &model](vk::Buffer& buffer, auto const& source, size_t first){
+        auto const elementSize{ sizeof(source[0]) };
+
+        if (source.empty())
+        {
+            return;
+        }
+
+        m.pendingUploads.emplace_back(PendingUpload{
+            .model = &model,
+            .buffer = &buffer,
+            .data = reinterpret_cast<u8 const*>(source.data()),
+            .size = source.size() * elementSize,
+            .offset = first * elementSize
         });
+
+        model.pendingBytes += source.size() * elementSize;
+    }};
+
+    auto const& loader{ model.loader };
+
+    std::ranges::transform(model.meshes, std::back_inserter(model.bounds), &Mesh::bounds);
+
+    queue(m.meshIndexBuffer, loader.indices, m.reserved.indexWord);
+    queue(m.meshPositionBuffer, loader.positions, m.reserved.vertex * 3);
+    queue(m.meshCoordsBuffer, loader.uvs, m.reserved.vertex * 2);
+    queue(m.meshNormalBuffer, loader.normals, m.reserved.vertex);
+    queue(m.meshParamsBuffer, loader.params, m.reserved.mesh);
+    queue(m.meshBoundsBuffer, model.bounds, m.reserved.mesh);
+    queue(m.meshletBuffer, loader.meshlets, m.reserved.meshlet);
+    queue(m.meshletVertexBuffer, loader.meshletVertices, m.reserved.meshletVertex);
+    queue(m.meshletTriangleBuffer, loader.meshletTriangles, m.reserved.meshletTriangle);
+
+    m.reserved.vertex += size.vertex;
+    m.reserved.indexWord += size.indexWord;
+    m.reserved.mesh += size.mesh;
+    m.reserved.meshlet += size.meshlet;
+    m.reserved.meshletVertex += size.meshletVertex;
+    m.reserved.meshletTriangle += size.meshletTriangle;
+}
+
+// Models become resident in the order their ranges were reserved, so the model's meshlets extend
+// the resident prefix of the meshlet buffer. Its geometry only lives on the device from here on.
+auto Renderer::makeResident(StreamedModel& model) -> void
+{
+    m.residentMeshletCount += static_cast<u32>(model.loader.meshlets.size());
+    this->addMeshes(model.meshes);
+
+    spdlog::info(
+        "Streamed model [ path: {}; meshes: {}; meshlets: {} ]",
+        model.path,
+        model.meshes.size(),
+        model.loader.meshlets.size()
+    );
+
+    model.loader = MeshLoader{};
+    model.bounds = {};
+    model.state.store(ModelState::eResident, std::memory_order_release);
+}
+
+// Transforms the mesh box of each instance in the range by its packed rows. Instances added since
+// the last update are inserted, which makes the refit rebuild; moved ones only refit.
+auto Renderer::updateInstanceBounds(u32 first, u32 end) -> void
+{
+    LF_PROFILE_ZONE("Renderer::updateInstanceBounds");
+
+    for (auto i{ first }; i < end; ++i)
+    {
+        auto const& instance{ m.instances[i] };
+        auto const& local{ m.meshes[instance.mesh].bounds };
+        auto bounds{ Aabb{} };
+
+        for (auto axis{ 0u }; axis < 3; ++axis)
+        {
+            auto const* row{ instance.rows[axis] };
+
+            auto const center{ row[0] * local.center[0] + row[1] * local.center[1] + row[2] * local.center[2] + row[3] };
+            auto const extent{
+                std::abs(row[0]) * local.extent[0] + std::abs(row[1]) * local.extent[1] + std::abs(row[2]) * local.extent[2]
+            };
+
+            bounds.min[axis] = center - extent;
+            bounds.max[axis] = center + extent;
+        }
+
+        if (i < m.instanceBvh.getItemCount())
+        {
+            m.instanceBvh.update(i, bounds);
+        }
+        else
+        {
+            m.instanceBvh.insert(bounds);
+        }
+    }
+
+    m.instanceBvh.refit();
+}
+
+auto Renderer::addInstance(u32 mesh, Transform const& transform) -> InstanceHandle
+{
+    if (mesh >= m.meshes.size())
+    {
+        throw std::runtime_error("Failed to add instance: mesh index out of range");
+    }
+
+    if (m.transforms.size() >= maxInstances)
+    {
+        throw std::runtime_error("Failed to add instance: instance capacity exceeded");
+    }
+
+    ++m.meshInstanceCounts[mesh];
+    m.instanceMeshes.emplace_back(mesh);
+
+    return m.transforms.add(transform);
+}
+
+// Nearest drawn instance whose world box the ray hits, or noInstance. Direction need not be
+// normalised.
+auto Renderer::pickInstance(glm::vec3 const& origin, glm::vec3 const& direction) const -> InstanceHandle
+{
+    // The meshlet paths draw only the identity instances, so nothing else would be under the ray.
+    if (m.geometryPath != GeometryPath::eIndirect)
+    {
+        return noInstance;
+    }
+
+    return m.instanceBvh.raycast(&origin.x, &direction.x, FLT_MAX).item;
+}
+
+// Draws are rebuilt from the meshes and their instance counts once the new instances are packed.
+auto Renderer::addMeshes(std::vector<Mesh> const& meshes) -> void
+{
+    for (auto const& mesh : meshes)
+    {
+        auto const index{ static_cast<u32>(m.meshes.size()) };
+
+        m.meshes.emplace_back(mesh);
+        m.meshInstanceCounts.emplace_back(0);
+
+        this->addInstance(index, Transform{});
     }
 }
@@ -7,8 +7,15 @@
 #include "Buffer.hpp"
 #include "Camera.hpp"
 #include "MeshLoader.hpp"
-#include "Thread.hpp"
+#include "TransformStore.hpp"
+#include "Bvh.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <string>
 #include <imgui.h>
 
 class Window;
@@ -16,7 +23,37 @@ class Window;
 class Renderer
 {
 public:
-    Renderer(Window& window);
+    // How the main pass turns meshes into triangles. The default indirect path draws every instance
+    // with 16- or 32-bit indices after frustum, occlusion and LOD selection on the GPU. Both meshlet
+    // paths draw each mesh once at its identity instance, ignoring addInstance and the transform
+    // store, culling clusters against the frustum and their normal cones; mesh shading needs
+    // VK_EXT_mesh_shader.
+    enum class GeometryPath : u32
+    {
+        eIndirect,
+        eMeshletCompute,
+        eMeshShader
+    };
+
+    // Index of a model in request order, returned by loadModelAsync.
+    using ModelHandle = u32;
+
+    enum class ModelState : u32
+    {
+        eLoading,
+        eUploading,
+        eResident,
+        eFailed
+    };
+
+    // Index of an instance in the transform store, returned by addInstance.
+    using InstanceHandle = u32;
+
+    static constexpr auto noInstance{ InstanceHandle{ Bvh::noItem } };
+
+public:
+    Renderer(Window& window, u32 framesInFlight = 2);
+    Renderer(glm::uvec2 extent, u32 framesInFlight = 2);
     ~Renderer();
     Renderer(Renderer const&) = delete;
     Renderer(Renderer&&) = delete;
@@ -24,19 +61,40 @@ public:
     auto operator=(Renderer&&) -> Renderer& = delete;
 
 private:
-    auto updateBuffers()       -> void;
-    auto recordCommandsEmpty() -> void;
-    auto recordCommands()      -> void;
-    auto onResize()            -> void;
-    auto allocateResources()   -> void;
-    auto createPipelines()     -> void;
-    auto initImgui()           -> void;
-    auto terminateImgui()      -> void;
+    struct StreamedModel;
+
+    auto initialize()                                -> void;
+    auto loadModel(std::string_view path)            -> void;
+    auto updateStreaming()                           -> void;
+    auto queueUploads(StreamedModel& model)          -> void;
+    auto makeResident(StreamedModel& model)          -> void;
+    auto addMeshes(std::vector<Mesh> const& meshes)  -> void;
+    auto updateBuffers()                             -> void;
+    auto updateInstances()                           -> void;
+    auto updateInstanceBounds(u32 first, u32 end)    -> void;
+    auto buildDraws()                                -> void;
+    auto recordCommands(vk::CommandBuffer& commands) -> void;
+    auto recordDrawCulling(vk::CommandBuffer& commands) -> void;
+    auto recordMeshletCulling(vk::CommandBuffer& commands, u32 meshletCount) -> void;
+    auto buildDepthPyramid(vk::CommandBuffer& commands) -> void;
+    auto onResize()                                  -> void;
+    auto allocateResources()                         -> void;
+    auto createPipelines()                           -> void;
+    auto createDepthPyramid()                        -> void;
+    auto initImgui()                                 -> void;
+    auto beginImguiFrame()                           -> void;
+    auto terminateImgui()                            -> void;
 
 public:
-    auto renderFrame()                    -> void;
-    auto waitIdle()                       -> void;
-    auto loadModel(std::string_view path) -> void;
+    auto renderFrame()                      -> void;
+    auto waitIdle()                         -> void;
+    auto loadModelAsync(std::string_view path)       -> ModelHandle;
+    auto getModelState(ModelHandle handle) const -> ModelState;
+    auto addInstance(u32 mesh, Transform const& transform) -> InstanceHandle;
+    auto pickInstance(glm::vec3 const& origin, glm::vec3 const& direction) const -> InstanceHandle;
+    auto readback()                         -> std::vector<u8>;
+    auto packImgui(ImDrawData* imDrawData)  -> void;
+    auto setGeometryPath(GeometryPath path) -> void;
 
 public:
     inline auto setCamera(Camera* pCamera) -> void
@@ -46,15 +104,161 @@ public:
 
     inline auto getWindow() -> Window&
     {
-        return m.window;
+        return *m.window;
+    }
+
+    inline auto getDevice() -> vk::Device&
+    {
+        return m.device;
+    }
+
+    inline auto getGeometryPath() const noexcept -> GeometryPath
+    {
+        return m.geometryPath;
+    }
+
+    // Every mesh gets an identity instance when it is loaded; more are added with addInstance.
+    inline auto getMeshCount() const noexcept -> u32
+    {
+        return static_cast<u32>(m.meshes.size());
+    }
+
+    // Box and sphere of a resident mesh in its own space; culling reads the same values from the
+    // mesh bounds buffer.
+    inline auto getMeshBounds(u32 mesh) const -> MeshBounds const&
+    {
+        return m.meshes.at(mesh).bounds;
+    }
+
+    // Instances are only added through addInstance, which keeps the per-instance mesh tables in
+    // step with the store; updates go straight to the store and are uploaded with the next frame.
+    inline auto getTransforms() const noexcept -> TransformStore const&
+    {
+        return m.transforms;
+    }
+
+    inline auto setTransform(InstanceHandle instance, Transform const& transform) -> void
+    {
+        m.transforms.set(instance, transform);
+    }
+
+    inline auto translateInstances(InstanceHandle first, u32 count, f32 x, f32 y, f32 z) -> void
+    {
+        m.transforms.translate(first, count, x, y, z);
+    }
+
+    // World-space boxes of every instance as of the last rendered frame, for frustum and ray
+    // queries on the CPU.
+    inline auto getInstanceBvh() const noexcept -> Bvh const&
+    {
+        return m.instanceBvh;
+    }
+
+    // Triangles of the instances drawn by the most recently retired indirect frame, after culling
+    // and LOD selection.
+    inline auto getDrawnTriangleCount() const noexcept -> u64
+    {
+        return m.drawnTriangleCount;
+    }
+
+    // Instances that survived frustum and occlusion culling in the most recently retired frame
+    // that rendered the indirect path.
+    inline auto getVisibleInstanceCount() const noexcept -> u32
+    {
+        return m.visibleInstanceCount;
+    }
+
+    // Screen-space error, in pixels, up to which the indirect path draws a coarser LOD; zero
+    // always draws the full mesh.
+    inline auto setLodErrorPixels(f32 pixels) noexcept -> void
+    {
+        m.lodErrorPixels = std::max(pixels, 0.f);
+    }
+
+    inline auto getLodErrorPixels() const noexcept -> f32
+    {
+        return m.lodErrorPixels;
     }
 
 private:
+    enum Pass : u32
+    {
+        eGridPass,
+        eMainPass,
+        ePostProcessingPass,
+        eImguiPass
+    };
+
+    static constexpr auto passCount{ 4u };
+
+    // Draws start after a header holding the 16-bit and 32-bit draw counts, followed by the
+    // visible instance and triangle counts written by culling.
+    static constexpr auto visibleDrawOffset{ sizeof(u32) * 4 };
+
+    // Instances across all meshes; each one reserves a visible slot per LOD of its mesh.
+    static constexpr auto maxInstances{ 1u << 16 };
+
+    // Bytes of streamed geometry handed to the uploader per frame.
+    static constexpr auto streamingBudget{ size_t{ 4 } << 20 };
+
+    // Minimum size of the device geometry buffers, which are allocated once.
+    static constexpr auto geometryCapacity{ cache::MeshBases{
+        .vertex = 1u << 21,
+        .indexWord = 1u << 23,
+        .mesh = 1u << 12,
+        .meshlet = 1u << 17,
+        .meshletVertex = 1u << 23,
+        .meshletTriangle = (1u << 17) * MeshLoader::maxMeshletTriangles * 3
+    }};
+
+    // A model requested with loadModelAsync. A background job imports it into its own loader;
+    // the render thread then places and uploads it, and appends its draws once resident.
+    struct StreamedModel
+    {
+        std::string             path;
+        MeshLoader              loader;
+        std::vector<Mesh>       meshes;
+        std::vector<MeshBounds> bounds;
+        size_t                  pendingBytes;
+        vk::UploadToken         token;
+        JobSystem::Counter      import;
+        std::atomic<ModelState> state{ ModelState::eLoading };
+    };
+
+    // Matches the Instance struct in the shaders: the rows of the affine transform, the mesh it
+    // draws and the transform's uniform scale.
+    struct InstanceData
+    {
+        f32 rows[3][4];
+        u32 mesh;
+        f32 scale;
+        u32 padding[2];
+    };
+
+    // Matches the MeshDraw struct in drawCull.comp: level L of a mesh is draw firstDraw + L.
+    struct MeshDraw
+    {
+        u32 firstDraw;
+        u32 lodCount;
+        f32 lodErrors[Mesh::maxLods];
+    };
+
+    // Part of one of a streamed model's arrays that has not been written to its buffer yet.
+    struct PendingUpload
+    {
+        StreamedModel* model;
+        vk::Buffer*    buffer;
+        u8 const*      data;
+        size_t         size;
+        size_t         offset;
+    };
+
     struct M
     {
-        Window&    window;
+        Window*    window;
         Camera*    currentCamera;
-        MeshLoader meshLoader;
+        JobSystem  jobs;
+        MeshLoader meshLoader{ &jobs };
 
         vk::Instance       instance;
         vk::Surface        surface;
@@ -65,12 +269,24 @@ private:
         vk::Image depthAttachment;
         vk::Image imguiFontTexture;
 
-        vk::Buffer indirectBuffer;
         vk::Buffer meshIndexBuffer;
         vk::Buffer meshPositionBuffer;
         vk::Buffer meshNormalBuffer;
         vk::Buffer meshCoordsBuffer;
+        vk::Buffer meshParamsBuffer;
+        vk::Buffer meshBoundsBuffer;
+        vk::Buffer meshletBuffer;
+        vk::Buffer meshletVertexBuffer;
+        vk::Buffer meshletTriangleBuffer;
+        vk::Buffer meshletDrawBuffer;
+        vk::Buffer visibleDrawBuffer;
+        vk::Buffer visibleInstanceBuffer;
+        vk::Buffer depthPyramidBuffer;
+        vk::Buffer drawStatsBuffer;
 
+        vk::SwapBuffer indirectBuffer;
+        vk::SwapBuffer instanceBuffer;
+        vk::SwapBuffer meshDrawBuffer;
         vk::SwapBuffer cameraUniformBuffer;
         vk::SwapBuffer imguiIndexBuffer;
         vk::SwapBuffer imguiVertexBuffer;
@@ -81,7 +297,47 @@ private:
         vk::Pipeline gridPipeline;
         vk::Pipeline imguiPipeline;
         vk::Pipeline postProcessingPipeline;
+        vk::Pipeline meshletPipeline;
+        vk::Pipeline meshletCullPipeline;
+        vk::Pipeline meshShaderPipeline;
+        vk::Pipeline drawCullPipeline;
+        vk::Pipeline depthPyramidPipeline;
+
+        std::vector<std::array<vk::CommandBuffer, passCount>> passCommands;
+        std::vector<vk::CommandBuffer>                        cullCommands;
+        std::vector<vk::CommandBuffer>                        sceneCommands;
+
+        std::vector<Mesh>                           meshes;
+        std::vector<vk::DrawIndexedIndirectCommand> indirectCommands;
+        std::vector<MeshDraw>                       meshDraws;
+        std::vector<u32>                            meshInstanceCounts;
+
+        TransformStore                  transforms;
+        std::vector<u32>                instanceMeshes;
+        std::vector<InstanceData>       instances;
+        std::vector<std::array<u32, 2>> staleInstanceRanges;
+        Bvh                             instanceBvh;
+        u32                             staleDrawFrames;
+
+        std::vector<std::unique_ptr<StreamedModel>> models;
+        std::deque<PendingUpload>                   pendingUploads;
+        std::atomic<bool>                           streamingCancelled;
+
+        cache::MeshBases capacity;
+        cache::MeshBases reserved;
+        size_t           queuedModels;
+        size_t           residentModels;
 
-        std::vector<vk::DrawIndirectCommand> indirectCommands;
+        glm::mat4    pyramidProjView;
+        f32          lodErrorPixels{ 1.f };
+        u64          drawnTriangleCount;
+        u64          sceneValue;
+        u32          staleAttachmentFrames;
+        u32          residentMeshletCount;
+        u32          index16DrawCount;
+        u32          pyramidLevelCount;
+        u32          visibleInstanceCount;
+        bool         pyramidValid;
+        GeometryPath geometryPath;
     } m;
 };
\ No newline at end of file
@@ -4,11 +4,29 @@
 #include <vk_mem_alloc.h>
 #include <stdexcept>
 
+// Concurrent buffers are shared by every family the device uses and never change owner. With a
+// single family there is nothing to share, so they stay exclusive.
+static auto applySharing(vk::Device const& device, vk::SharingMode sharing, VkBufferCreateInfo& createInfo) -> vk::SharingMode
+{
+    auto const families{ device.getUniqueQueueFamilies() };
+
+    if (sharing == vk::SharingMode::eExclusive || families.size() < 2)
+    {
+        return vk::SharingMode::eExclusive;
+    }
+
+    createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    createInfo.queueFamilyIndexCount = static_cast<u32>(families.size());
+    createInfo.pQueueFamilyIndices = families.data();
+
+    return vk::SharingMode::eConcurrent;
+}
+
 vk::Buffer::Buffer()
     : m{}
 {}
 
-vk::Buffer::Buffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType memoryType)
+vk::Buffer::Buffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType memoryType, SharingMode sharing)
     : m{
         .device = &device,
         .size = size
@@ -20,6 +38,8 @@ vk::Buffer::Buffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType
         .usage = usage
     }};
 
+    m.sharing = applySharing(device, sharing, bufferCreateInfo);
+
     auto allocationCreateInfo{ VmaAllocationCreateInfo{
         .usage = VMA_MEMORY_USAGE_AUTO
     }};
@@ -61,7 +81,7 @@ vk::Buffer::~Buffer()
 {
     if (m.device && m.buffer && m.allocation)
     {
-        vmaDestroyBuffer(*m.device, m.buffer, m.allocation);
+        m.device->getDeletionQueue().push(m.buffer, m.allocation);
     }
     
     m = {};
@@ -81,96 +101,29 @@ auto vk::Buffer::operator=(Buffer&& other) -> Buffer&
     return *this;
 }
 
-auto vk::Buffer::write(void const* data, size_t size) -> void
+auto vk::Buffer::write(void const* data, size_t size) -> UploadToken
 {
     if (m.memoryType & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
     {
         std::memcpy(m.mappedData, data, size);
         vmaFlushAllocation(*m.device, m.allocation, 0, size);
-    }
-    else
-    {
-        auto const bufferCreateInfo{ VkBufferCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size = size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-        }};
-
-        auto const allocationCreateInfo{ VmaAllocationCreateInfo{
-            .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-                     VMA_ALLOCATION_CREATE_MAPPED_BIT,
-            .usage = VMA_MEMORY_USAGE_AUTO,
-        }};
-
-        auto stagingBuffer{ VkBuffer{} };
-        auto stagingAllocation{ VmaAllocation{} };
-        auto allocationInfo{ VmaAllocationInfo{} };
-
-        if (vmaCreateBuffer(*m.device, &bufferCreateInfo, &allocationCreateInfo, &stagingBuffer, &stagingAllocation, &allocationInfo))
-        {
-            throw std::runtime_error("Failed to allocate buffer");
-        }
-
-        memcpy(allocationInfo.pMappedData, data, size);
-        vmaFlushAllocation(*m.device, stagingAllocation, 0, size);
 
-        m.device->transferSubmit([&](CommandBuffer& command)
-        {
-            auto const copy{ VkBufferCopy{
-                .size = size
-            }};
-
-            vkCmdCopyBuffer(command, stagingBuffer, m.buffer, 1, &copy);
-        });
-
-        vmaDestroyBuffer(*m.device, stagingBuffer, stagingAllocation);
+        return {};
     }
+
+    return m.device->getUploader().upload(data, size, m.buffer, 0, m.sharing);
 }
 
-auto vk::Buffer::write(void const* data, size_t size, size_t offset) -> void
+auto vk::Buffer::write(void const* data, size_t size, size_t offset) -> UploadToken
 {
     if (m.memoryType & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
     {
         std::memcpy(m.mappedData + offset, data, size);
-    }
-    else
-    {
-        auto const bufferCreateInfo{ VkBufferCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size = size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-        }};
-
-        auto const allocationCreateInfo{ VmaAllocationCreateInfo{
-            .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-                     VMA_ALLOCATION_CREATE_MAPPED_BIT,
-            .usage = VMA_MEMORY_USAGE_AUTO,
-        }};
-
-        auto stagingBuffer{ VkBuffer{} };
-        auto stagingAllocation{ VmaAllocation{} };
-        auto allocationInfo{ VmaAllocationInfo{} };
-
-        if (vmaCreateBuffer(*m.device, &bufferCreateInfo, &allocationCreateInfo, &stagingBuffer, &stagingAllocation, &allocationInfo))
-        {
-            throw std::runtime_error("Failed to allocate buffer");
-        }
 
-        memcpy(allocationInfo.pMappedData, data, size);
-        vmaFlushAllocation(*m.device, stagingAllocation, 0, size);
-
-        m.device->transferSubmit([&](CommandBuffer& command)
-        {
-            auto const copy{ VkBufferCopy{
-                .dstOffset = offset,
-                .size = size
-            }};
-
-            vkCmdCopyBuffer(command, stagingBuffer, m.buffer, 1, &copy);
-        });
-
-        vmaDestroyBuffer(*m.device, stagingBuffer, stagingAllocation);
+        return {};
     }
+
+    return m.device->getUploader().upload(data, size, m.buffer, offset, m.sharing);
 }
 
 auto vk::Buffer::flush(size_t size) -> void
@@ -181,11 +134,23 @@ auto vk::Buffer::flush(size_t size) -> void
     }
 }
 
+// Only host-visible buffers can be read; the caller makes sure the device is done writing.
+auto vk::Buffer::read(void* data, size_t size, size_t offset) -> void
+{
+    if (!(m.memoryType & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+    {
+        throw std::runtime_error("Failed to read buffer: memory is not host visible");
+    }
+
+    vmaInvalidateAllocation(*m.device, m.allocation, offset, size);
+    std::memcpy(data, m.mappedData + offset, size);
+}
+
 vk::SwapBuffer::SwapBuffer()
     : m{}
 {}
 
-vk::SwapBuffer::SwapBuffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType memoryType)
+vk::SwapBuffer::SwapBuffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType memoryType, SharingMode sharing)
     : m{
         .device = &device,
         .size = size
@@ -197,6 +162,8 @@ vk::SwapBuffer::SwapBuffer(Device& device, u32 size, BufferUsageFlags usage, Mem
         .usage = usage
     }};
 
+    m.sharing = applySharing(device, sharing, bufferCreateInfo);
+
     auto allocationCreateInfo{ VmaAllocationCreateInfo{
         .usage = VMA_MEMORY_USAGE_AUTO
     }};
@@ -224,7 +191,7 @@ vk::SwapBuffer::SwapBuffer(Device& device, u32 size, BufferUsageFlags usage, Mem
 
     auto allocationInfo{ VmaAllocationInfo{} };
     
-    m.frames = std::pmr::vector<M::Frame>{ m.device->getCommandBuffers().size(), &pmr::g_rsrc };
+    m.frames = std::pmr::vector<M::Frame>{ m.device->getFramesInFlight(), &pmr::g_persistentArena };
     for (auto& frame : m.frames)
     {
         if (vmaCreateBuffer(*m.device, &bufferCreateInfo, &allocationCreateInfo, &frame.buffer, &frame.allocation, &allocationInfo))
@@ -244,7 +211,7 @@ vk::SwapBuffer::~SwapBuffer()
     {
         if (m.device && frame.buffer && frame.allocation)
         {
-            vmaDestroyBuffer(*m.device, frame.buffer, frame.allocation);
+            m.device->getDeletionQueue().push(frame.buffer, frame.allocation);
         }
     }
     
@@ -265,7 +232,7 @@ auto vk::SwapBuffer::operator=(SwapBuffer&& other) -> SwapBuffer&
     return *this;
 }
 
-auto vk::SwapBuffer::write(void const* data, size_t size) -> void
+auto vk::SwapBuffer::write(void const* data, size_t size) -> UploadToken
 {
     auto& frame{ m.frames[m.device->getFrameIndex()] };
 
@@ -273,99 +240,32 @@ auto vk::SwapBuffer::write(void const* data, size_t size) -> void
     {
         std::memcpy(frame.mappedData, data, size);
         vmaFlushAllocation(*m.device, frame.allocation, 0, size);
-    }
-    else
-    {
-        auto const bufferCreateInfo{ VkBufferCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size = size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-        }};
-
-        auto const allocationCreateInfo{ VmaAllocationCreateInfo{
-            .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-                     VMA_ALLOCATION_CREATE_MAPPED_BIT,
-            .usage = VMA_MEMORY_USAGE_AUTO,
-        }};
-
-        auto stagingBuffer{ VkBuffer{} };
-        auto stagingAllocation{ VmaAllocation{} };
-        auto allocationInfo{ VmaAllocationInfo{} };
-
-        if (vmaCreateBuffer(*m.device, &bufferCreateInfo, &allocationCreateInfo, &stagingBuffer, &stagingAllocation, &allocationInfo))
-        {
-            throw std::runtime_error("Failed to allocate buffer");
-        }
-
-        memcpy(allocationInfo.pMappedData, data, size);
-        vmaFlushAllocation(*m.device, stagingAllocation, 0, size);
-
-        m.device->transferSubmit([&](CommandBuffer& command)
-        {
-            auto const copy{ VkBufferCopy{
-                .size = size
-            }};
-
-            vkCmdCopyBuffer(command, stagingBuffer, frame.buffer, 1, &copy);
-        });
 
-        vmaDestroyBuffer(*m.device, stagingBuffer, stagingAllocation);
+        return {};
     }
+
+    return m.device->getUploader().upload(data, size, frame.buffer, 0, m.sharing);
 }
 
-auto vk::SwapBuffer::write(void const* data, size_t size, size_t offset) -> void
+auto vk::SwapBuffer::write(void const* data, size_t size, size_t offset) -> UploadToken
 {
     auto& frame{ m.frames[m.device->getFrameIndex()] };
 
     if (m.memoryType & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
     {
         std::memcpy(frame.mappedData + offset, data, size);
-    }
-    else
-    {
-        auto const bufferCreateInfo{ VkBufferCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size = size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-        }};
-
-        auto const allocationCreateInfo{ VmaAllocationCreateInfo{
-            .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-                     VMA_ALLOCATION_CREATE_MAPPED_BIT,
-            .usage = VMA_MEMORY_USAGE_AUTO,
-        }};
-
-        auto stagingBuffer{ VkBuffer{} };
-        auto stagingAllocation{ VmaAllocation{} };
-        auto allocationInfo{ VmaAllocationInfo{} };
-
-        if (vmaCreateBuffer(*m.device, &bufferCreateInfo, &allocationCreateInfo, &stagingBuffer, &stagingAllocation, &allocationInfo))
-        {
-            throw std::runtime_error("Failed to allocate buffer");
-        }
-
-        memcpy(allocationInfo.pMappedData, data, size);
-        vmaFlushAllocation(*m.device, stagingAllocation, 0, size);
-
-        m.device->transferSubmit([&](CommandBuffer& command)
-        {
-            auto const copy{ VkBufferCopy{
-                .dstOffset = offset,
-                .size = size
-            }};
 
-            vkCmdCopyBuffer(command, stagingBuffer, frame.buffer, 1, &copy);
-        });
-
-        vmaDestroyBuffer(*m.device, stagingBuffer, stagingAllocation);
+        return {};
     }
+
+    return m.device->getUploader().upload(data, size, frame.buffer, offset, m.sharing);
 }
 
-auto vk::SwapBuffer::flush(size_t size) -> void
+auto vk::SwapBuffer::flush(size_t size, size_t offset) -> void
 {
     if (m.memoryType & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
     {
         auto& frame{ m.frames[m.device->getFrameIndex()] };
-        vmaFlushAllocation(*m.device, frame.allocation, 0, size);
+        vmaFlushAllocation(*m.device, frame.allocation, offset, size);
     }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Types.hpp"
 #include "VulkanEnums.hpp"
 #include "BufferResource.hpp"
+#include "Uploader.hpp"
 #include <cstring>
 
 struct VkBuffer_T;
@@ -18,7 +19,7 @@ namespace vk
     {
     public:
         Buffer();
-        Buffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType memoryType);
+        Buffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType memoryType, SharingMode sharing = SharingMode::eExclusive);
         ~Buffer();
         Buffer(Buffer const&) = delete;
         Buffer(Buffer&& other);
@@ -26,9 +27,10 @@ namespace vk
         auto operator=(Buffer&& other) -> Buffer&;
 
     public:
-        auto write(void const* data, size_t size) -> void;
-        auto write(void const* data, size_t size, size_t offset) -> void;
+        auto write(void const* data, size_t size) -> UploadToken;
+        auto write(void const* data, size_t size, size_t offset) -> UploadToken;
         auto flush(size_t size) -> void;
+        auto read(void* data, size_t size, size_t offset = 0) -> void;
 
     public:
         inline operator VkBuffer() const noexcept
@@ -51,6 +53,7 @@ namespace vk
             u8*           mappedData;
             u32           memoryType;
             u32           size;
+            SharingMode   sharing;
         } m;
     };
 
@@ -58,7 +61,7 @@ namespace vk
     {
     public:
         SwapBuffer();
-        SwapBuffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType memoryType);
+        SwapBuffer(Device& device, u32 size, BufferUsageFlags usage, MemoryType memoryType, SharingMode sharing = SharingMode::eExclusive);
         ~SwapBuffer();
         SwapBuffer(SwapBuffer const&) = delete;
         SwapBuffer(SwapBuffer&& other);
@@ -66,9 +69,9 @@ namespace vk
         auto operator=(SwapBuffer&& other) -> SwapBuffer&;
 
     public:
-        auto write(void const* data, size_t size) -> void;
-        auto write(void const* data, size_t size, size_t offset) -> void;
-        auto flush(size_t size) -> void;
+        auto write(void const* data, size_t size) -> UploadToken;
+        auto write(void const* data, size_t size, size_t offset) -> UploadToken;
+        auto flush(size_t size, size_t offset = 0) -> void;
 
     public:
         template<typename T>
@@ -93,11 +96,12 @@ namespace vk
                 u8* mappedData;
             };
             
-            std::pmr::vector<Frame> frames;
+            std::pmr::vector<Frame> frames{ &pmr::g_persistentArena };
             
-            Device* device;
-            u32     memoryType;
-            u32     size;
+            Device*     device;
+            u32         memoryType;
+            u32         size;
+            SharingMode sharing;
         } m;
     };
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Image.hpp"
 #include "Buffer.hpp"
 #include "Pipeline.hpp"
+#include "BufferResource.hpp"
 #include <volk.h>
 #include <stdexcept>
 
@@ -14,7 +15,7 @@ vk::CommandBuffer::~CommandBuffer()
 {
     if (m.device && m.pool)
     {
-        vkDestroyCommandPool(*m.device, m.pool, nullptr);
+        m.device->getDeletionQueue().push(m.pool);
     }
 
     m = {};
@@ -45,7 +46,7 @@ auto vk::CommandBuffer::begin(u32 frameIndex) -> void
 
     auto const beginInfo{ VkCommandBufferBeginInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
     }};
 
     if (vkBeginCommandBuffer(m.buffer, &beginInfo))
@@ -54,6 +55,51 @@ auto vk::CommandBuffer::begin(u32 frameIndex) -> void
     }
 }
 
+// Secondary buffers recorded inside a render pass instance begun with secondaryContents.
+// Dynamic state is not inherited, so the viewport and scissor are set here.
+auto vk::CommandBuffer::beginInherited(u32 frameIndex, Image const& image, Image const* pDepthImage) -> void
+{
+    m.frameIndex = frameIndex;
+
+    if (vkResetCommandPool(*m.device, m.pool, 0))
+    {
+        throw std::runtime_error("Failed to reset VkCommandPool");
+    }
+
+    auto const colorFormat{ static_cast<VkFormat>(image.getFormat()) };
+
+    auto const renderingInheritance{ VkCommandBufferInheritanceRenderingInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &colorFormat,
+        .depthAttachmentFormat = pDepthImage ? static_cast<VkFormat>(pDepthImage->getFormat()) : VK_FORMAT_UNDEFINED,
+        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+    }};
+
+    auto const inheritance{ VkCommandBufferInheritanceInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = &renderingInheritance
+    }};
+
+    auto const beginInfo{ VkCommandBufferBeginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+        .pInheritanceInfo = &inheritance
+    }};
+
+    if (vkBeginCommandBuffer(m.buffer, &beginInfo))
+    {
+        throw std::runtime_error("Failed to begin VkCommandBuffer");
+    }
+
+    this->setViewport(image.getSize());
+}
+
+auto vk::CommandBuffer::beginInheritedPresent(u32 frameIndex) -> void
+{
+    this->beginInherited(frameIndex, m.device->getSwapchainImage(m.device->getImageIndex()));
+}
+
 auto vk::CommandBuffer::end() -> void
 {
     if (vkEndCommandBuffer(m.buffer))
@@ -62,24 +108,27 @@ auto vk::CommandBuffer::end() -> void
     }
 }
 
-auto vk::CommandBuffer::beginPresent() -> void
+auto vk::CommandBuffer::beginPresent(bool secondaryContents) -> void
 {
-    barrier(m.device->getSwapchainImage(m.frameIndex), ImageLayout::eColorAttachment);
-    beginRendering(m.device->getSwapchainImage(m.frameIndex));
+    barrier(m.device->getSwapchainImage(m.device->getImageIndex()), ImageLayout::eColorAttachment);
+    beginRendering(m.device->getSwapchainImage(m.device->getImageIndex()), nullptr, secondaryContents);
 }
 
 auto vk::CommandBuffer::endPresent() -> void
 {
     endRendering();
-    barrier(m.device->getSwapchainImage(m.frameIndex), ImageLayout::ePresent);
+    barrier(
+        m.device->getSwapchainImage(m.device->getImageIndex()),
+        m.device->isHeadless() ? ImageLayout::eTransferSrc : ImageLayout::ePresent
+    );
 }
 
 auto vk::CommandBuffer::pushConstant(const void* pData, size_t dataSize) -> void
 {
-    vkCmdPushConstants(m.buffer, *m.currentPipeline, VK_SHADER_STAGE_VERTEX_BIT, 0, dataSize, pData);
+    vkCmdPushConstants(m.buffer, *m.currentPipeline, m.currentPipeline->getPushConstantStages(), 0, static_cast<u32>(dataSize), pData);
 }
 
-auto vk::CommandBuffer::beginRendering(Image const& image, Image const* pDepthImage) -> void
+auto vk::CommandBuffer::beginRendering(Image const& image, Image const* pDepthImage, bool secondaryContents) -> void
 {
     {
         auto const colorAttachment{ VkRenderingAttachmentInfo{
@@ -105,6 +154,7 @@ auto vk::CommandBuffer::beginRendering(Image const& image, Image const* pDepthIm
 
         auto const renderingInfo{ VkRenderingInfo{
             .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+            .flags = secondaryContents ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : VkRenderingFlags{},
             .renderArea = {
                 .extent = { 
                     .width  = image.getWidth(),
@@ -119,25 +169,10 @@ auto vk::CommandBuffer::beginRendering(Image const& image, Image const* pDepthIm
 
         vkCmdBeginRendering(m.buffer, &renderingInfo);
     }
-    {
-        auto const viewport{ VkViewport{
-            .y = static_cast<f32>(image.getHeight()),
-            .width  =  static_cast<f32>(image.getWidth()),
-            .height = -static_cast<f32>(image.getHeight()),
-            .maxDepth = 1.f
-        }};
 
-        vkCmdSetViewport(m.buffer, 0, 1, &viewport);
-    }
+    if (!secondaryContents)
     {
-        auto scissor{ VkRect2D{
-            .extent = {
-                .width  = image.getWidth(),
-                .height = image.getHeight()
-            }
-        }};
-
-        vkCmdSetScissor(m.buffer, 0, 1, &scissor);
+        this->setViewport(image.getSize());
     }
 }
 
@@ -146,15 +181,59 @@ auto vk::CommandBuffer::endRendering() -> void
     vkCmdEndRendering(m.buffer);
 }
 
-auto vk::CommandBuffer::copyBuffer(Buffer& source, Buffer& destination, size_t size) -> void
+auto vk::CommandBuffer::executeCommands(ArrayProxy<CommandBuffer*> commandBuffers) -> void
+{
+    auto scratch{ pmr::ScratchScope{} };
+    auto handles{ std::pmr::vector<VkCommandBuffer>{ scratch.get() } };
+    handles.reserve(commandBuffers.size());
+
+    for (auto const pCommandBuffer : commandBuffers)
+    {
+        handles.emplace_back(pCommandBuffer->m.buffer);
+    }
+
+    vkCmdExecuteCommands(m.buffer, static_cast<u32>(handles.size()), handles.data());
+}
+
+// Zones do not nest; each command buffer has at most one open zone at a time.
+auto vk::CommandBuffer::beginZone(char const* name) -> void
+{
+    m.zone = m.device->getGpuProfiler().beginZone(*this, m.frameIndex, name);
+}
+
+auto vk::CommandBuffer::endZone() -> void
+{
+    m.device->getGpuProfiler().endZone(*this, m.frameIndex, m.zone);
+    m.zone = GpuProfiler::noZone;
+}
+
+auto vk::CommandBuffer::copyBuffer(Buffer& source, Buffer& destination, size_t size, size_t sourceOffset, size_t destinationOffset) -> void
 {
     auto const copy{ VkBufferCopy{
+        .srcOffset = sourceOffset,
+        .dstOffset = destinationOffset,
         .size = size
     }};
 
     vkCmdCopyBuffer(m.buffer, source, destination, 1, &copy);
 }
 
+auto vk::CommandBuffer::copyBuffer(SwapBuffer& source, Buffer& destination, size_t size, size_t sourceOffset, size_t destinationOffset) -> void
+{
+    auto const copy{ VkBufferCopy{
+        .srcOffset = sourceOffset,
+        .dstOffset = destinationOffset,
+        .size = size
+    }};
+
+    vkCmdCopyBuffer(m.buffer, source(m.frameIndex), destination, 1, &copy);
+}
+
+auto vk::CommandBuffer::fillBuffer(Buffer& buffer, u32 value, size_t size) -> void
+{
+    vkCmdFillBuffer(m.buffer, buffer, 0, size, value);
+}
+
 auto vk::CommandBuffer::barrier(Image& image, ImageLayout layout) -> void
 {
     auto imageBarrier{ VkImageMemoryBarrier2{
@@ -193,6 +272,24 @@ auto vk::CommandBuffer::barrier(Image& image, ImageLayout layout) -> void
             imageBarrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
             imageBarrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
             break;
+        case ImageLayout::eTransferSrc:
+            imageBarrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+            imageBarrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            break;
+        [[unlikely]] default:
+            break;
+        }
+        break;
+    case ImageLayout::eTransferSrc:
+        imageBarrier.srcAccessMask = VK_ACCESS_2_NONE;
+        imageBarrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+
+        switch (layout)
+        {
+        case ImageLayout::eColorAttachment:
+            imageBarrier.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
+            imageBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            break;
         [[unlikely]] default:
             break;
         }
@@ -213,7 +310,7 @@ auto vk::CommandBuffer::barrier(Image& image, ImageLayout layout) -> void
         break;
     case ImageLayout::eShaderRead:
         imageBarrier.srcAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
-        imageBarrier.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        imageBarrier.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
 
         switch (layout)
         {
@@ -221,9 +318,14 @@ auto vk::CommandBuffer::barrier(Image& image, ImageLayout layout) -> void
             imageBarrier.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
             imageBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
             break;
+        case ImageLayout::eDepthAttachment:
+            imageBarrier.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            imageBarrier.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+            break;
         [[unlikely]] default:
             break;
         }
+        break;
     case ImageLayout::eDepthAttachment:
         imageBarrier.srcAccessMask = VK_ACCESS_2_NONE;
         imageBarrier.srcStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
@@ -234,6 +336,11 @@ auto vk::CommandBuffer::barrier(Image& image, ImageLayout layout) -> void
             imageBarrier.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
             imageBarrier.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
             break;
+        case ImageLayout::eShaderRead:
+            imageBarrier.srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            imageBarrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+            imageBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            break;
         [[unlikely]] default:
             break;
         }
@@ -252,6 +359,124 @@ auto vk::CommandBuffer::barrier(Image& image, ImageLayout layout) -> void
     image.setLayout(layout);
 }
 
+// Makes all writes by the source stages visible to the destination stages; buffers carry no
+// layout, so the stages are the whole description.
+auto vk::CommandBuffer::barrier(Buffer& buffer, PipelineStageFlags source, PipelineStageFlags destination) -> void
+{
+    this->barrier(buffer, source, Access::eMemoryWrite, destination, Access::eMemoryRead | Access::eMemoryWrite);
+}
+
+// Synchronization2 barrier over a range of the buffer with explicit access masks, for hazards
+// where the broad memory masks above would over-synchronise.
+auto vk::CommandBuffer::barrier(
+    Buffer& buffer,
+    PipelineStageFlags sourceStage,
+    AccessFlags sourceAccess,
+    PipelineStageFlags destinationStage,
+    AccessFlags destinationAccess,
+    size_t offset,
+    size_t size
+) -> void
+{
+    auto const bufferBarrier{ VkBufferMemoryBarrier2{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+        .srcStageMask = sourceStage,
+        .srcAccessMask = sourceAccess,
+        .dstStageMask = destinationStage,
+        .dstAccessMask = destinationAccess,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = buffer,
+        .offset = offset,
+        .size = size
+    }};
+
+    auto const dependency{ VkDependencyInfo{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .bufferMemoryBarrierCount = 1,
+        .pBufferMemoryBarriers = &bufferBarrier
+    }};
+
+    vkCmdPipelineBarrier2(m.buffer, &dependency);
+}
+
+// Releases a range of the buffer when recorded on the source queue and acquires it when recorded
+// on the destination queue; both halves must name the same range.
+auto vk::CommandBuffer::transferOwnership(VkBuffer buffer, QueueType source, QueueType destination, size_t offset, size_t size) -> void
+{
+    auto const sourceFamily{ m.device->getQueueFamily(source) };
+    auto const destinationFamily{ m.device->getQueueFamily(destination) };
+
+    if (sourceFamily == destinationFamily)
+    {
+        return;
+    }
+
+    auto const release{ m.queue == source };
+
+    auto const bufferBarrier{ VkBufferMemoryBarrier2{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+        .srcStageMask = release ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT : VK_PIPELINE_STAGE_2_NONE,
+        .srcAccessMask = release ? VK_ACCESS_2_MEMORY_WRITE_BIT : VK_ACCESS_2_NONE,
+        .dstStageMask = release ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .dstAccessMask = release ? VK_ACCESS_2_NONE : VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+        .srcQueueFamilyIndex = sourceFamily,
+        .dstQueueFamilyIndex = destinationFamily,
+        .buffer = buffer,
+        .offset = offset,
+        .size = size
+    }};
+
+    auto const dependency{ VkDependencyInfo{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .bufferMemoryBarrierCount = 1,
+        .pBufferMemoryBarriers = &bufferBarrier
+    }};
+
+    vkCmdPipelineBarrier2(m.buffer, &dependency);
+}
+
+// Same as above for the whole image, which may change layout on the way; both halves must name
+// the same layouts. The tracked layout is left alone, as the caller owns the layouts here.
+auto vk::CommandBuffer::transferOwnership(Image& image, QueueType source, QueueType destination, ImageLayout oldLayout, ImageLayout newLayout) -> void
+{
+    auto const sourceFamily{ m.device->getQueueFamily(source) };
+    auto const destinationFamily{ m.device->getQueueFamily(destination) };
+
+    if (sourceFamily == destinationFamily)
+    {
+        return;
+    }
+
+    auto const release{ m.queue == source };
+
+    auto const imageBarrier{ VkImageMemoryBarrier2{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .srcStageMask = release ? VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT : VK_PIPELINE_STAGE_2_NONE,
+        .srcAccessMask = release ? VK_ACCESS_2_MEMORY_WRITE_BIT : VK_ACCESS_2_NONE,
+        .dstStageMask = release ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .dstAccessMask = release ? VK_ACCESS_2_NONE : VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+        .oldLayout = static_cast<VkImageLayout>(oldLayout),
+        .newLayout = static_cast<VkImageLayout>(newLayout),
+        .srcQueueFamilyIndex = sourceFamily,
+        .dstQueueFamilyIndex = destinationFamily,
+        .image = image,
+        .subresourceRange = {
+            .aspectMask = image.getAspect(),
+            .levelCount = VK_REMAINING_MIP_LEVELS,
+            .layerCount = VK_REMAINING_ARRAY_LAYERS
+        }
+    }};
+
+    auto const dependency{ VkDependencyInfo{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .imageMemoryBarrierCount = 1,
+        .pImageMemoryBarriers = &imageBarrier
+    }};
+
+    vkCmdPipelineBarrier2(m.buffer, &dependency);
+}
+
 auto vk::CommandBuffer::bindIndexBuffer16(Buffer& indexBuffer) -> void
 {
     vkCmdBindIndexBuffer(m.buffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
@@ -309,6 +534,36 @@ auto vk::CommandBuffer::drawIndirect(Buffer& buffer, u32 drawCount) -> void
     vkCmdDrawIndirect(m.buffer, buffer, 0, drawCount, sizeof(VkDrawIndirectCommand));
 }
 
+auto vk::CommandBuffer::drawIndirectCount(Buffer& buffer, u32 maxDraws) -> void
+{
+    vkCmdDrawIndirectCount(m.buffer, buffer, sizeof(u32), buffer, 0, maxDraws, sizeof(VkDrawIndirectCommand));
+}
+
+auto vk::CommandBuffer::drawIndexedIndirect(Buffer& buffer, u32 drawCount, size_t offset) -> void
+{
+    vkCmdDrawIndexedIndirect(m.buffer, buffer, offset, drawCount, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+auto vk::CommandBuffer::drawIndexedIndirect(SwapBuffer& buffer, u32 drawCount, size_t offset) -> void
+{
+    vkCmdDrawIndexedIndirect(m.buffer, buffer(m.frameIndex), offset, drawCount, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+auto vk::CommandBuffer::drawMeshTasks(u32 groupCountX, u32 groupCountY, u32 groupCountZ) -> void
+{
+    vkCmdDrawMeshTasksEXT(m.buffer, groupCountX, groupCountY, groupCountZ);
+}
+
+auto vk::CommandBuffer::dispatch(u32 groupCountX, u32 groupCountY, u32 groupCountZ) -> void
+{
+    vkCmdDispatch(m.buffer, groupCountX, groupCountY, groupCountZ);
+}
+
+auto vk::CommandBuffer::dispatchIndirect(Buffer& buffer, size_t offset) -> void
+{
+    vkCmdDispatchIndirect(m.buffer, buffer, offset);
+}
+
 auto vk::CommandBuffer::drawIndexedIndirectCount(Buffer& buffer, u32 maxDraws) -> void
 {
     vkCmdDrawIndexedIndirectCount(m.buffer, buffer, sizeof(u32), buffer, 0, maxDraws, sizeof(VkDrawIndexedIndirectCommand));
@@ -319,12 +574,21 @@ auto vk::CommandBuffer::drawIndexedIndirectCount(SwapBuffer& buffer, u32 maxDraw
     vkCmdDrawIndexedIndirectCount(m.buffer, buffer(m.frameIndex), sizeof(u32), buffer(m.frameIndex), 0, maxDraws, sizeof(VkDrawIndexedIndirectCommand));
 }
 
-auto vk::CommandBuffer::allocate(Device* pDevice) -> void
+// Draws from offset with the count read from countOffset of the same buffer, for producers that
+// write several ranges each with its own count.
+auto vk::CommandBuffer::drawIndexedIndirectCount(Buffer& buffer, size_t offset, size_t countOffset, u32 maxDraws) -> void
+{
+    vkCmdDrawIndexedIndirectCount(m.buffer, buffer, offset, buffer, countOffset, maxDraws, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+auto vk::CommandBuffer::allocate(Device* pDevice, QueueType queue, CommandBufferLevel level) -> void
 {
     m.device = pDevice;
+    m.queue = queue;
 
     auto const commandPoolCreateInfo{ VkCommandPoolCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = m.device->getQueueFamily(queue)
     }};
 
     if (vkCreateCommandPool(*m.device, &commandPoolCreateInfo, nullptr, &m.pool))
@@ -335,7 +599,7 @@ auto vk::CommandBuffer::allocate(Device* pDevice) -> void
     auto const commandBufferAllocateInfo{ VkCommandBufferAllocateInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
         .commandPool = m.pool,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .level = static_cast<VkCommandBufferLevel>(level),
         .commandBufferCount = 1
     }};
 
@@ -343,4 +607,25 @@ auto vk::CommandBuffer::allocate(Device* pDevice) -> void
     {
         throw std::runtime_error("Failed to allocate VkCommandBuffer");
     }
+}
+
+auto vk::CommandBuffer::setViewport(glm::uvec2 extent) -> void
+{
+    auto const viewport{ VkViewport{
+        .y = static_cast<f32>(extent.y),
+        .width  =  static_cast<f32>(extent.x),
+        .height = -static_cast<f32>(extent.y),
+        .maxDepth = 1.f
+    }};
+
+    vkCmdSetViewport(m.buffer, 0, 1, &viewport);
+
+    auto const scissor{ VkRect2D{
+        .extent = {
+            .width  = extent.x,
+            .height = extent.y
+        }
+    }};
+
+    vkCmdSetScissor(m.buffer, 0, 1, &scissor);
 }
\ No newline at end of file
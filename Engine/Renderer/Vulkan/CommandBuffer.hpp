@@ -1,13 +1,16 @@
 #pragma once
 #include "Types.hpp"
 #include "VulkanEnums.hpp"
+#include "ArrayProxy.hpp"
 #include <glm/glm.hpp>
 
 struct VkCommandPool_T;
 struct VkCommandBuffer_T;
+struct VkBuffer_T;
 
 using VkCommandPool   = VkCommandPool_T*;
 using VkCommandBuffer = VkCommandBuffer_T*;
+using VkBuffer        = VkBuffer_T*;
 
 namespace vk
 {
@@ -46,14 +49,25 @@ namespace vk
 
     public:
         auto begin(u32 frameIndex = 0) -> void;
+        auto beginInherited(u32 frameIndex, Image const& image, Image const* pDepthImage = nullptr) -> void;
+        auto beginInheritedPresent(u32 frameIndex) -> void;
         auto end() -> void;
-        auto beginPresent() -> void;
+        auto beginPresent(bool secondaryContents = false) -> void;
         auto endPresent() -> void;
         auto pushConstant(void const* pData, size_t dataSize) -> void;
-        auto beginRendering(Image const& image, Image const* pDepthImage = nullptr) -> void;
+        auto beginRendering(Image const& image, Image const* pDepthImage = nullptr, bool secondaryContents = false) -> void;
         auto endRendering() -> void;
-        auto copyBuffer(Buffer& source, Buffer& destination, size_t size) -> void;
+        auto executeCommands(ArrayProxy<CommandBuffer*> commandBuffers) -> void;
+        auto beginZone(char const* name) -> void;
+        auto endZone() -> void;
+        auto copyBuffer(Buffer& source, Buffer& destination, size_t size, size_t sourceOffset = 0, size_t destinationOffset = 0) -> void;
+        auto copyBuffer(SwapBuffer& source, Buffer& destination, size_t size, size_t sourceOffset = 0, size_t destinationOffset = 0) -> void;
+        auto fillBuffer(Buffer& buffer, u32 value, size_t size = ~size_t{}) -> void;
         auto barrier(Image& image, ImageLayout layout) -> void;
+        auto barrier(Buffer& buffer, PipelineStageFlags source, PipelineStageFlags destination) -> void;
+        auto barrier(Buffer& buffer, PipelineStageFlags sourceStage, AccessFlags sourceAccess, PipelineStageFlags destinationStage, AccessFlags destinationAccess, size_t offset = 0, size_t size = ~size_t{}) -> void;
+        auto transferOwnership(VkBuffer buffer, QueueType source, QueueType destination, size_t offset = 0, size_t size = ~size_t{}) -> void;
+        auto transferOwnership(Image& image, QueueType source, QueueType destination, ImageLayout oldLayout, ImageLayout newLayout) -> void;
         auto bindIndexBuffer16(Buffer& indexBuffer) -> void;
         auto bindIndexBuffer16(SwapBuffer& indexBuffer) -> void;
         auto bindIndexBuffer32(Buffer& indexBuffer) -> void;
@@ -62,9 +76,16 @@ namespace vk
         auto draw(u32 vertexCount) -> void;
         auto drawIndexed(u32 indexCount, u32 indexOffset = 0, i32 vertexOffset = 0) -> void;
         auto drawIndirect(Buffer& buffer, u32 drawCount) -> void;
+        auto drawIndirectCount(Buffer& buffer, u32 maxDraws) -> void;
+        auto drawIndexedIndirect(Buffer& buffer, u32 drawCount, size_t offset = 0) -> void;
+        auto drawIndexedIndirect(SwapBuffer& buffer, u32 drawCount, size_t offset = 0) -> void;
+        auto drawMeshTasks(u32 groupCountX, u32 groupCountY = 1, u32 groupCountZ = 1) -> void;
+        auto dispatch(u32 groupCountX, u32 groupCountY = 1, u32 groupCountZ = 1) -> void;
+        auto dispatchIndirect(Buffer& buffer, size_t offset = 0) -> void;
         auto drawIndexedIndirectCount(Buffer& buffer, u32 maxDraws) -> void;
         auto drawIndexedIndirectCount(SwapBuffer& buffer, u32 maxDraws) -> void;
-        auto allocate(Device* pDevice) -> void;
+        auto drawIndexedIndirectCount(Buffer& buffer, size_t offset, size_t countOffset, u32 maxDraws) -> void;
+        auto allocate(Device* pDevice, QueueType queue = QueueType::eGraphics, CommandBufferLevel level = CommandBufferLevel::ePrimary) -> void;
 
     public:
         using Handle = VkCommandBuffer;
@@ -74,6 +95,14 @@ namespace vk
             return m.buffer;
         }
 
+        inline auto getQueue() const noexcept -> QueueType
+        {
+            return m.queue;
+        }
+
+    private:
+        auto setViewport(glm::uvec2 extent) -> void;
+
     private:
         struct M
         {
@@ -81,7 +110,9 @@ namespace vk
             Pipeline*       currentPipeline;
             VkCommandPool   pool;
             VkCommandBuffer buffer;
+            QueueType       queue;
             u32             frameIndex;
+            u32             zone;
         } m;
     };
 }
\ No newline at end of file
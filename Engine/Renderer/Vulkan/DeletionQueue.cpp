@@ -0,0 +1,180 @@
+#include "DeletionQueue.hpp"
+#include "Device.hpp"
+#include <volk.h>
+#include <vk_mem_alloc.h>
+
+vk::DeletionQueue::DeletionQueue()
+    : m{}
+{}
+
+vk::DeletionQueue::DeletionQueue(Device& device)
+    : m{
+        .device = &device
+    }
+{}
+
+vk::DeletionQueue::~DeletionQueue()
+{
+    this->flush();
+
+    m = {};
+}
+
+vk::DeletionQueue::DeletionQueue(DeletionQueue&& other)
+    : m{ std::move(other.m) }
+{
+    other.m = {};
+}
+
+auto vk::DeletionQueue::operator=(DeletionQueue&& other) -> DeletionQueue&
+{
+    m = std::move(other.m);
+    other.m = {};
+
+    return *this;
+}
+
+auto vk::DeletionQueue::push(VkBuffer buffer, VmaAllocation allocation) -> void
+{
+    this->enqueue(ObjectType::eBuffer, buffer, allocation);
+}
+
+auto vk::DeletionQueue::push(VkImage image, VmaAllocation allocation) -> void
+{
+    this->enqueue(ObjectType::eImage, image, allocation);
+}
+
+auto vk::DeletionQueue::push(VkImageView imageView) -> void
+{
+    this->enqueue(ObjectType::eImageView, imageView);
+}
+
+auto vk::DeletionQueue::push(VkPipeline pipeline) -> void
+{
+    this->enqueue(ObjectType::ePipeline, pipeline);
+}
+
+auto vk::DeletionQueue::push(VkPipelineLayout layout) -> void
+{
+    this->enqueue(ObjectType::ePipelineLayout, layout);
+}
+
+auto vk::DeletionQueue::push(VkDescriptorSetLayout setLayout) -> void
+{
+    this->enqueue(ObjectType::eDescriptorSetLayout, setLayout);
+}
+
+auto vk::DeletionQueue::push(VkSwapchainKHR swapchain) -> void
+{
+    this->enqueue(ObjectType::eSwapchain, swapchain);
+}
+
+auto vk::DeletionQueue::push(VkCommandPool pool) -> void
+{
+    this->enqueue(ObjectType::eCommandPool, pool);
+}
+
+auto vk::DeletionQueue::collect() -> void
+{
+    if (m.entries.empty())
+    {
+        return;
+    }
+
+    auto const completed{ std::array{
+        m.device->currentGpuValue(QueueType::eGraphics),
+        m.device->currentGpuValue(QueueType::eCompute),
+        m.device->currentGpuValue(QueueType::eTransfer)
+    }};
+
+    while (!m.entries.empty())
+    {
+        auto const& entry{ m.entries.front() };
+
+        if (entry.values[0] > completed[0] ||
+            entry.values[1] > completed[1] ||
+            entry.values[2] > completed[2])
+        {
+            break;
+        }
+
+        this->destroy(entry);
+        m.entries.pop_front();
+    }
+}
+
+// Called once the recorded frame is submitted; pending entries now wait for that submission too.
+auto vk::DeletionQueue::seal() -> void
+{
+    for (auto entry{ m.entries.rbegin() }; entry != m.entries.rend() && entry->values[0] == pendingValue; ++entry)
+    {
+        entry->values = {
+            m.device->signalValue(QueueType::eGraphics),
+            m.device->signalValue(QueueType::eCompute),
+            m.device->signalValue(QueueType::eTransfer)
+        };
+    }
+}
+
+auto vk::DeletionQueue::flush() -> void
+{
+    for (auto const& entry : m.entries)
+    {
+        this->destroy(entry);
+    }
+
+    m.entries.clear();
+}
+
+auto vk::DeletionQueue::enqueue(ObjectType type, void* handle, VmaAllocation allocation) -> void
+{
+    if (!handle)
+    {
+        return;
+    }
+
+    // The frame being recorded has not been submitted yet, so the latest signal values do not cover it.
+    auto const recording{ m.device->isRecording() };
+
+    m.entries.emplace_back(Entry{
+        .values = {
+            recording ? pendingValue : m.device->signalValue(QueueType::eGraphics),
+            recording ? pendingValue : m.device->signalValue(QueueType::eCompute),
+            recording ? pendingValue : m.device->signalValue(QueueType::eTransfer)
+        },
+        .type = type,
+        .handle = handle,
+        .allocation = allocation
+    });
+}
+
+auto vk::DeletionQueue::destroy(Entry const& entry) -> void
+{
+    switch (entry.type)
+    {
+    case ObjectType::eBuffer:
+        vmaDestroyBuffer(*m.device, static_cast<VkBuffer>(entry.handle), entry.allocation);
+        break;
+    case ObjectType::eImage:
+        vmaDestroyImage(*m.device, static_cast<VkImage>(entry.handle), entry.allocation);
+        break;
+    case ObjectType::eImageView:
+        vkDestroyImageView(*m.device, static_cast<VkImageView>(entry.handle), nullptr);
+        break;
+    case ObjectType::ePipeline:
+        vkDestroyPipeline(*m.device, static_cast<VkPipeline>(entry.handle), nullptr);
+        break;
+    case ObjectType::ePipelineLayout:
+        vkDestroyPipelineLayout(*m.device, static_cast<VkPipelineLayout>(entry.handle), nullptr);
+        break;
+    case ObjectType::eDescriptorSetLayout:
+        vkDestroyDescriptorSetLayout(*m.device, static_cast<VkDescriptorSetLayout>(entry.handle), nullptr);
+        break;
+    case ObjectType::eSwapchain:
+        vkDestroySwapchainKHR(*m.device, static_cast<VkSwapchainKHR>(entry.handle), nullptr);
+        break;
+    case ObjectType::eCommandPool:
+        vkDestroyCommandPool(*m.device, static_cast<VkCommandPool>(entry.handle), nullptr);
+        break;
+    }
+}
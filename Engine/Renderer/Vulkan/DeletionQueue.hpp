@@ -0,0 +1,96 @@
+#pragma once
+#include "Types.hpp"
+#include <array>
+#include <deque>
+
+struct VkBuffer_T;
+struct VkImage_T;
+struct VkImageView_T;
+struct VkPipeline_T;
+struct VkPipelineLayout_T;
+struct VkDescriptorSetLayout_T;
+struct VkSwapchainKHR_T;
+struct VkCommandPool_T;
+struct VmaAllocation_T;
+
+using VkBuffer              = VkBuffer_T*;
+using VkImage               = VkImage_T*;
+using VkImageView           = VkImageView_T*;
+using VkPipeline            = VkPipeline_T*;
+using VkPipelineLayout      = VkPipelineLayout_T*;
+using VkDescriptorSetLayout = VkDescriptorSetLayout_T*;
+using VkSwapchainKHR        = VkSwapchainKHR_T*;
+using VkCommandPool         = VkCommandPool_T*;
+using VmaAllocation         = VmaAllocation_T*;
+
+namespace vk
+{
+    class Device;
+
+    // Holds handles until every submission made before they were pushed, including the frame being
+    // recorded at the time, has completed on all queues.
+    class DeletionQueue
+    {
+    public:
+        DeletionQueue();
+        DeletionQueue(Device& device);
+        ~DeletionQueue();
+        DeletionQueue(DeletionQueue const&) = delete;
+        DeletionQueue(DeletionQueue&& other);
+        auto operator=(DeletionQueue const&)  -> DeletionQueue& = delete;
+        auto operator=(DeletionQueue&& other) -> DeletionQueue&;
+
+    public:
+        auto push(VkBuffer buffer, VmaAllocation allocation) -> void;
+        auto push(VkImage image, VmaAllocation allocation)   -> void;
+        auto push(VkImageView imageView)                     -> void;
+        auto push(VkPipeline pipeline)                       -> void;
+        auto push(VkPipelineLayout layout)                   -> void;
+        auto push(VkDescriptorSetLayout setLayout)           -> void;
+        auto push(VkSwapchainKHR swapchain)                  -> void;
+        auto push(VkCommandPool pool)                        -> void;
+        auto collect() -> void;
+        auto seal()    -> void;
+        auto flush()   -> void;
+
+    public:
+        inline auto size() const noexcept -> size_t
+        {
+            return m.entries.size();
+        }
+
+    private:
+        enum class ObjectType
+        {
+            eBuffer,
+            eImage,
+            eImageView,
+            ePipeline,
+            ePipelineLayout,
+            eDescriptorSetLayout,
+            eSwapchain,
+            eCommandPool
+        };
+
+        struct Entry
+        {
+            std::array<u64, 3> values;
+            ObjectType         type;
+            void*              handle;
+            VmaAllocation      allocation;
+        };
+
+        // Marks entries pushed while a frame is being recorded; the frame's own submission may still use them.
+        static constexpr auto pendingValue{ ~u64{} };
+
+        auto enqueue(ObjectType type, void* handle, VmaAllocation allocation = nullptr) -> void;
+        auto destroy(Entry const& entry) -> void;
+
+    private:
+        struct M
+        {
+            Device*           device;
+            std::deque<Entry> entries;
+        } m;
+    };
+}
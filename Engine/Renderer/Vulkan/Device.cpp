@@ -4,16 +4,19 @@
 #include "PhysicalDevice.hpp"
 #include "Surface.hpp"
 #include "Window.hpp"
+#include "Profiler.hpp"
 #include <volk.h>
 #include <vk_mem_alloc.h>
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <stdexcept>
 
-vk::Device::Device(Instance& instance, Surface& surface, PhysicalDevice& physicalDevice)
+vk::Device::Device(Instance& instance, Surface& surface, PhysicalDevice& physicalDevice, u32 framesInFlight)
     : m{ 
         .surface = &surface,
         .physicalDevice = &physicalDevice,
-        .surfaceFormat = surface.getFormat(physicalDevice)
+        .surfaceFormat = surface.getFormat(physicalDevice),
+        .framesInFlight = std::max(framesInFlight, 1u)
     }
 {
     this->createDevice(instance);
@@ -24,16 +27,48 @@ vk::Device::Device(Instance& instance, Surface& surface, PhysicalDevice& physica
     this->createTransferResources();
     this->createDescriptorPool();
     this->createSampler();
+
+    m.gpuProfiler = GpuProfiler{ *this, *m.physicalDevice, m.framesInFlight, m.pipelineStatistics };
     
     spdlog::info("Created device");
 }
 
+vk::Device::Device(Instance& instance, PhysicalDevice& physicalDevice, glm::uvec2 extent, u32 framesInFlight)
+    : m{
+        .physicalDevice = &physicalDevice,
+        .surfaceFormat = Format::eRGBA8_unorm,
+        .swapchainExtent = extent,
+        .framesInFlight = std::max(framesInFlight, 1u)
+    }
+{
+    this->createDevice(instance);
+    this->createAllocator(instance);
+    this->createOffscreenTargets();
+    this->createCommandBuffers();
+    this->createSyncObjects();
+    this->createTransferResources();
+    this->createDescriptorPool();
+    this->createSampler();
+
+    m.gpuProfiler = GpuProfiler{ *this, *m.physicalDevice, m.framesInFlight, m.pipelineStatistics };
+
+    spdlog::info("Created headless device [ width: {}; height: {} ]", extent.x, extent.y);
+}
+
 vk::Device::~Device()
 {
+    if (m.device)
+    {
+        vkDeviceWaitIdle(m.device);
+    }
+
+    m.uploader.~Uploader();
+    m.gpuProfiler.~GpuProfiler();
     m.transferCommandBuffer.~CommandBuffer();
 
     m.commandBuffers.clear();
     m.swapchainImages.clear();
+    m.deletionQueue.flush();
 
     if (m.sampler)
     {
@@ -45,16 +80,22 @@ vk::Device::~Device()
         vkDestroyDescriptorPool(m.device, m.descriptorPool, nullptr);
     }
 
-    if (m.transferFence)
+    for (auto const semaphore : m.presentSemaphores)
     {
-        vkDestroyFence(m.device, m.transferFence, nullptr);
+        vkDestroySemaphore(m.device, semaphore, nullptr);
     }
 
-    for (auto i{ static_cast<u32>(m.fences.size()) }; i--; )
+    for (auto const semaphore : m.renderSemaphores)
     {
-        vkDestroyFence(m.device, m.fences[i], nullptr);
-        vkDestroySemaphore(m.device, m.presentSemaphores[i], nullptr);
-        vkDestroySemaphore(m.device, m.renderSemaphores[i], nullptr);
+        vkDestroySemaphore(m.device, semaphore, nullptr);
+    }
+
+    for (auto const timeline : m.timelines)
+    {
+        if (timeline)
+        {
+            vkDestroySemaphore(m.device, timeline, nullptr);
+        }
     }
 
     if (m.swapchain)
@@ -93,7 +134,14 @@ auto vk::Device::operator=(Device&& other) -> Device&
 
 auto vk::Device::waitIdle() -> void
 {
-    vkDeviceWaitIdle(m.device);
+    auto const waitInfo{ VkSemaphoreWaitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = static_cast<u32>(m.timelines.size()),
+        .pSemaphores = m.timelines.data(),
+        .pValues = m.timelineValues.data()
+    }};
+
+    vkWaitSemaphores(m.device, &waitInfo, ~0ull);
 }
 
 auto vk::Device::checkSwapchainState(Window& window) -> SwapchainResult
@@ -112,7 +160,6 @@ auto vk::Device::checkSwapchainState(Window& window) -> SwapchainResult
             }
         }
 
-        vkDeviceWaitIdle(m.device);
         this->createSwapchain();
         previousSize = window.getSize();
 
@@ -122,81 +169,245 @@ auto vk::Device::checkSwapchainState(Window& window) -> SwapchainResult
     return SwapchainResult::eSuccess;
 }
 
+// Waits until the frame slot's previous submission has retired, so its command pool, per-frame
+// buffers and descriptor sets may be rewritten, then acquires the image this frame presents to.
+auto vk::Device::beginFrame() -> CommandBuffer&
+{
+    this->waitGpuValue(QueueType::eGraphics, m.frameValues[m.frameIndex]);
+    m.deletionQueue.collect();
+    m.gpuProfiler.collect(m.frameIndex);
+    m.recording = true;
+
+    if (this->isHeadless())
+    {
+        m.imageIndex = m.frameIndex;
+
+        auto& commands{ m.commandBuffers[m.frameIndex] };
+        commands.begin(m.frameIndex);
+
+        return commands;
+    }
+
+    switch (vkAcquireNextImageKHR(m.device, m.swapchain, ~0ull, m.renderSemaphores[m.frameIndex], nullptr, &m.imageIndex))
+    {
+    [[likely]]   case VK_SUCCESS:
+    [[unlikely]] case VK_SUBOPTIMAL_KHR: break;
+    [[unlikely]] default: throw std::runtime_error("Failed to acquire next swapchain images");
+    }
+
+    auto& commands{ m.commandBuffers[m.frameIndex] };
+    commands.begin(m.frameIndex);
+
+    return commands;
+}
+
 auto vk::Device::submitAndPresent() -> void
 {
+    LF_PROFILE_ZONE("Device::submitAndPresent");
+
+    m.commandBuffers[m.frameIndex].end();
+    m.uploader.flush();
+
+    if (this->isHeadless())
     {
-        vkWaitForFences(m.device, 1, &m.fences[m.frameIndex], 0u, ~0ull);
-        
-        switch (vkAcquireNextImageKHR(m.device, m.swapchain, ~0ull, m.renderSemaphores[m.frameIndex], nullptr, &m.imageIndex))
-        {
-        [[likely]]   case VK_SUCCESS:
-        [[unlikely]] case VK_SUBOPTIMAL_KHR: break;
-        [[unlikely]] default: throw std::runtime_error("Failed to acquire next swapchain images");
-        }
+        m.frameValues[m.frameIndex] = this->submit(QueueType::eGraphics, m.commandBuffers[m.frameIndex]);
+        m.frameIndex = (m.frameIndex + 1) % m.framesInFlight;
+        m.recording = false;
+        m.deletionQueue.seal();
+
+        return;
     }
+
     {
-        auto const waitStage{ VkPipelineStageFlags{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT} };
-        auto const commandBuffer{ VkCommandBuffer{m.commandBuffers[m.imageIndex]} };
-        auto const submitInfo{ VkSubmitInfo{
-            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .waitSemaphoreCount = 1,
-            .pWaitSemaphores = &m.renderSemaphores[m.frameIndex],
-            .pWaitDstStageMask = &waitStage,
-            .commandBufferCount = 1,
-            .pCommandBuffers = &commandBuffer,
-            .signalSemaphoreCount = 1,
-            .pSignalSemaphores = &m.presentSemaphores[m.frameIndex]
+        auto const wait{ SemaphoreSubmit{
+            .semaphore = m.renderSemaphores[m.frameIndex],
+            .stage = PipelineStage::eColorAttachmentOutput
         }};
 
-        vkResetFences(m.device, 1, &m.fences[m.frameIndex]);
-        if (vkQueueSubmit(m.queue, 1, &submitInfo, m.fences[m.frameIndex])) [[unlikely]]
-        {
-            throw std::runtime_error("Failed to submit command buffers");
-        }
+        auto const signal{ SemaphoreSubmit{
+            .semaphore = m.presentSemaphores[m.imageIndex],
+            .stage = PipelineStage::eAllCommands
+        }};
+
+        m.frameValues[m.frameIndex] = this->submit(QueueType::eGraphics, m.commandBuffers[m.frameIndex], wait, signal);
+        m.recording = false;
+        m.deletionQueue.seal();
     }
     {
         auto const presentInfo{ VkPresentInfoKHR{
             .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
             .waitSemaphoreCount = 1,
-            .pWaitSemaphores = &m.presentSemaphores[m.frameIndex],
+            .pWaitSemaphores = &m.presentSemaphores[m.imageIndex],
             .swapchainCount = 1,
             .pSwapchains = &m.swapchain,
             .pImageIndices = &m.imageIndex
         }};
 
-        switch (vkQueuePresentKHR(m.queue, &presentInfo))
+        switch (vkQueuePresentKHR(*this, &presentInfo))
         {
         [[likely]]   case VK_SUCCESS: break;
         [[unlikely]] default: throw std::runtime_error("Failed to present frame");
         }
 
-        m.frameIndex = (m.frameIndex + 1) % m.commandBuffers.size();
+        m.frameIndex = (m.frameIndex + 1) % m.framesInFlight;
     }
 }
 
 auto vk::Device::transferSubmit(std::function<void(CommandBuffer&)>&& function) -> void
 {
-    vkResetFences(m.device, 1, &m.transferFence);
-
     m.transferCommandBuffer.begin();
     {
         function(m.transferCommandBuffer);
     }
     m.transferCommandBuffer.end();
 
-    auto const command{ VkCommandBuffer{m.transferCommandBuffer} };
-    auto const submitInfo{ VkSubmitInfo{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &command
+    this->waitGpuValue(QueueType::eGraphics, this->submit(QueueType::eGraphics, m.transferCommandBuffer));
+}
+
+auto vk::Device::submit(
+    QueueType                   type,
+    CommandBuffer&              commands,
+    ArrayProxy<SemaphoreSubmit> waits,
+    ArrayProxy<SemaphoreSubmit> signals
+) -> u64
+{
+    auto const index{ static_cast<u32>(type) };
+    auto const value{ ++m.timelineValues[index] };
+
+    auto scratch{ pmr::ScratchScope{} };
+    auto semaphoreInfos{ std::pmr::vector<VkSemaphoreSubmitInfo>{ scratch.get() } };
+    semaphoreInfos.reserve(waits.size() + signals.size() + 1);
+
+    for (auto const& semaphore : waits)
+    {
+        semaphoreInfos.emplace_back(VkSemaphoreSubmitInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = semaphore.semaphore,
+            .value = semaphore.value,
+            .stageMask = semaphore.stage
+        });
+    }
+
+    for (auto const& semaphore : signals)
+    {
+        semaphoreInfos.emplace_back(VkSemaphoreSubmitInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = semaphore.semaphore,
+            .value = semaphore.value,
+            .stageMask = semaphore.stage
+        });
+    }
+
+    semaphoreInfos.emplace_back(VkSemaphoreSubmitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = m.timelines[index],
+        .value = value,
+        .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+    });
+
+    auto const commandBufferInfo{ VkCommandBufferSubmitInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+        .commandBuffer = commands
     }};
 
-    if (vkQueueSubmit(m.queue, 1, &submitInfo, m.transferFence))
+    auto const submitInfo{ VkSubmitInfo2{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+        .waitSemaphoreInfoCount = waits.size(),
+        .pWaitSemaphoreInfos = semaphoreInfos.data(),
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &commandBufferInfo,
+        .signalSemaphoreInfoCount = signals.size() + 1,
+        .pSignalSemaphoreInfos = semaphoreInfos.data() + waits.size()
+    }};
+
+    if (vkQueueSubmit2(this->getQueue(type), 1, &submitInfo, nullptr))
     {
         throw std::runtime_error("Failed to submit command buffers");
     }
 
-    vkWaitForFences(m.device, 1, &m.transferFence, 0, ~0ull);
+    return value;
+}
+
+auto vk::Device::currentGpuValue(QueueType type) const -> u64
+{
+    auto value{ u64{} };
+    vkGetSemaphoreCounterValue(m.device, m.timelines[static_cast<u32>(type)], &value);
+
+    return value;
+}
+
+auto vk::Device::waitGpuValue(QueueType type, u64 value) const -> void
+{
+    auto const waitInfo{ VkSemaphoreWaitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &m.timelines[static_cast<u32>(type)],
+        .pValues = &value
+    }};
+
+    vkWaitSemaphores(m.device, &waitInfo, ~0ull);
+}
+
+// Copies the most recently submitted offscreen target into host memory as tightly packed RGBA8.
+// Drains the device first, so it is meant for captures and checks rather than every frame.
+auto vk::Device::readback() -> std::vector<u8>
+{
+    auto& image{ m.swapchainImages[m.imageIndex] };
+
+    if (!this->isHeadless() || image.getLayout() != ImageLayout::eTransferSrc)
+    {
+        throw std::runtime_error("Failed to read back frame: no offscreen frame has been rendered");
+    }
+
+    this->waitIdle();
+
+    auto const size{ static_cast<size_t>(m.swapchainExtent.x) * m.swapchainExtent.y * 4 };
+
+    auto const bufferCreateInfo{ VkBufferCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT
+    }};
+
+    auto const allocationCreateInfo{ VmaAllocationCreateInfo{
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
+                 VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO,
+    }};
+
+    auto buffer    { VkBuffer{} };
+    auto allocation{ VmaAllocation{} };
+    auto allocationInfo{ VmaAllocationInfo{} };
+
+    if (vmaCreateBuffer(m.allocator, &bufferCreateInfo, &allocationCreateInfo, &buffer, &allocation, &allocationInfo))
+    {
+        throw std::runtime_error("Failed to allocate readback buffer");
+    }
+
+    this->transferSubmit([&](CommandBuffer& commands){
+        auto const region{ VkBufferImageCopy{
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .layerCount = 1
+            },
+            .imageExtent = {
+                .width = m.swapchainExtent.x,
+                .height = m.swapchainExtent.y,
+                .depth = 1
+            }
+        }};
+
+        vkCmdCopyImageToBuffer(commands, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+    });
+
+    vmaInvalidateAllocation(m.allocator, allocation, 0, VK_WHOLE_SIZE);
+
+    auto const data{ static_cast<u8 const*>(allocationInfo.pMappedData) };
+    auto pixels{ std::vector<u8>{ data, data + size } };
+
+    vmaDestroyBuffer(m.allocator, buffer, allocation);
+
+    return pixels;
 }
 
 auto vk::Device::createDevice(Instance& instance) -> void
@@ -206,35 +417,95 @@ auto vk::Device::createDevice(Instance& instance) -> void
     auto properties{ std::vector<VkQueueFamilyProperties>{propertyCount} };
     vkGetPhysicalDeviceQueueFamilyProperties(*m.physicalDevice, &propertyCount, properties.data());
 
-    auto family{ u32{} };
-    auto index { u32{} };
+    auto graphicsFamily{ u32{} };
+    auto computeFamily { ~0u };
+    auto transferFamily{ ~0u };
 
     for (auto i{ u32{} }; i < propertyCount; ++i)
     {
-        auto presentSupport{ VkBool32{false} };
-        vkGetPhysicalDeviceSurfaceSupportKHR(*m.physicalDevice, i, *m.surface, &presentSupport);
+        auto presentSupport{ VkBool32{ this->isHeadless() } };
+
+        if (!this->isHeadless())
+        {
+            vkGetPhysicalDeviceSurfaceSupportKHR(*m.physicalDevice, i, *m.surface, &presentSupport);
+        }
 
         if (properties[i].queueFlags & VK_QUEUE_GRAPHICS_BIT &&
             properties[i].queueFlags & VK_QUEUE_COMPUTE_BIT &&
             presentSupport)
         {
-            family = i;
-            index = 0;
+            graphicsFamily = i;
             break;
         }
     }
 
+    for (auto i{ u32{} }; i < propertyCount; ++i)
+    {
+        auto const flags{ properties[i].queueFlags };
+
+        if (flags & VK_QUEUE_GRAPHICS_BIT)
+        {
+            continue;
+        }
+
+        if (flags & VK_QUEUE_COMPUTE_BIT && computeFamily == ~0u)
+        {
+            computeFamily = i;
+        }
+
+        if (flags & VK_QUEUE_TRANSFER_BIT && !(flags & VK_QUEUE_COMPUTE_BIT) && transferFamily == ~0u)
+        {
+            transferFamily = i;
+        }
+    }
+
+    if (computeFamily == ~0u)
+    {
+        computeFamily = graphicsFamily;
+    }
+
+    if (transferFamily == ~0u)
+    {
+        transferFamily = graphicsFamily;
+    }
+
+    m.queueFamilies = { graphicsFamily, computeFamily, transferFamily };
+
     auto const queuePriority{ f32{1.f} };
+    auto queueCreateInfos{ std::vector<VkDeviceQueueCreateInfo>{} };
+
+    for (auto const family : m.queueFamilies)
+    {
+        if (std::ranges::any_of(queueCreateInfos, [family](auto const& info){ return info.queueFamilyIndex == family; }))
+        {
+            continue;
+        }
 
-    auto const queueCreateInfo{ VkDeviceQueueCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-        .queueFamilyIndex = family,
-        .queueCount = 1,
-        .pQueuePriorities = &queuePriority
+        m.uniqueFamilies[m.uniqueFamilyCount++] = family;
+
+        queueCreateInfos.emplace_back(VkDeviceQueueCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = family,
+            .queueCount = 1,
+            .pQueuePriorities = &queuePriority
+        });
+    }
+
+    auto supportedFeatures{ VkPhysicalDeviceFeatures{} };
+    vkGetPhysicalDeviceFeatures(*m.physicalDevice, &supportedFeatures);
+
+    m.pipelineStatistics = supportedFeatures.pipelineStatisticsQuery;
+    m.meshShader = m.physicalDevice->hasMeshShader();
+
+    auto meshShaderFeatures{ VkPhysicalDeviceMeshShaderFeaturesEXT{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
+        .taskShader = true,
+        .meshShader = true
     }};
 
     auto vulkan11Features{ VkPhysicalDeviceVulkan11Features{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+        .pNext = m.meshShader ? &meshShaderFeatures : nullptr,
         .storageBuffer16BitAccess = true,
         .shaderDrawParameters = true
     }};
@@ -247,7 +518,9 @@ auto vk::Device::createDevice(Instance& instance) -> void
         .descriptorIndexing = true,
         .shaderSampledImageArrayNonUniformIndexing = true,
         .descriptorBindingPartiallyBound = true,
-        .runtimeDescriptorArray = true
+        .runtimeDescriptorArray = true,
+        .hostQueryReset = true,
+        .timelineSemaphore = true
     }};
 
     auto vulkan13Features{ VkPhysicalDeviceVulkan13Features{
@@ -262,19 +535,30 @@ auto vk::Device::createDevice(Instance& instance) -> void
         .pNext = &vulkan13Features,
         .features = {
             .multiDrawIndirect = true,
-            .fillModeNonSolid = true
+            .fillModeNonSolid = true,
+            .pipelineStatisticsQuery = m.pipelineStatistics
         }
     }};
 
-    auto const swapchainExtension{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    auto extensions{ std::vector<char const*>{} };
+
+    if (!this->isHeadless())
+    {
+        extensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+
+    if (m.meshShader)
+    {
+        extensions.emplace_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    }
 
     auto const deviceCreateInfo{ VkDeviceCreateInfo{
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
         .pNext = &enabledFeatures,
-        .queueCreateInfoCount = 1,
-        .pQueueCreateInfos = &queueCreateInfo,
-        .enabledExtensionCount = 1,
-        .ppEnabledExtensionNames = &swapchainExtension
+        .queueCreateInfoCount = static_cast<u32>(queueCreateInfos.size()),
+        .pQueueCreateInfos = queueCreateInfos.data(),
+        .enabledExtensionCount = static_cast<u32>(extensions.size()),
+        .ppEnabledExtensionNames = extensions.data()
     }};
 
     if (vkCreateDevice(*m.physicalDevice, &deviceCreateInfo, nullptr, &m.device))
@@ -283,10 +567,16 @@ auto vk::Device::createDevice(Instance& instance) -> void
     }
 
     volkLoadDevice(m.device);
+    m.deletionQueue = DeletionQueue{ *this };
 
-    vkGetDeviceQueue(m.device, family, index, &m.queue);
+    for (auto i{ size_t{} }; i < m.queues.size(); ++i)
+    {
+        vkGetDeviceQueue(m.device, m.queueFamilies[i], 0, &m.queues[i]);
+    }
 
-    spdlog::info("Graphics queue [ family: {}; index: {} ]", family, index);
+    spdlog::info("Graphics queue [ family: {} ]", graphicsFamily);
+    spdlog::info("Compute queue  [ family: {}; dedicated: {} ]", computeFamily, this->hasDedicatedQueue(QueueType::eCompute));
+    spdlog::info("Transfer queue [ family: {}; dedicated: {} ]", transferFamily, this->hasDedicatedQueue(QueueType::eTransfer));
 }
 
 auto vk::Device::createAllocator(Instance& instance) -> void
@@ -383,7 +673,7 @@ auto vk::Device::createSwapchain() -> void
 
     if (m.oldSwapchain)
     {
-        vkDestroySwapchainKHR(m.device, m.oldSwapchain, nullptr);
+        m.deletionQueue.push(m.oldSwapchain);
         m.oldSwapchain = nullptr;
     }
 
@@ -392,17 +682,46 @@ auto vk::Device::createSwapchain() -> void
     auto images{ std::vector<VkImage>{imageCount} };
     vkGetSwapchainImagesKHR(m.device, m.swapchain, &imageCount, images.data());
 
-    m.swapchainImages = std::pmr::vector<Image>{ imageCount, &pmr::g_rsrc };
+    m.swapchainImages.resize(imageCount);
 
     for (auto i{ imageCount }; i--; )
     {
         m.swapchainImages[i] = Image(this, images[i], m.surfaceFormat, {extent.width, extent.height});
     }
+
+    auto const semaphoreCreateInfo{ VkSemaphoreCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
+    }};
+
+    while (m.presentSemaphores.size() < imageCount)
+    {
+        if (vkCreateSemaphore(m.device, &semaphoreCreateInfo, nullptr, &m.presentSemaphores.emplace_back()))
+        {
+            throw std::runtime_error("Failed to create VkSemaphore");
+        }
+    }
+}
+
+auto vk::Device::createOffscreenTargets() -> void
+{
+    m.swapchainImages.clear();
+
+    for (auto i{ u32{} }; i < m.framesInFlight; ++i)
+    {
+        auto& image{ m.swapchainImages.emplace_back(
+            this,
+            m.swapchainExtent,
+            ImageUsage::eColorAttachment | ImageUsage::eTransferSrc,
+            m.surfaceFormat
+        )};
+
+        image.setLayout(ImageLayout::eUndefined);
+    }
 }
 
 auto vk::Device::createCommandBuffers() -> void
 {
-    m.commandBuffers = std::pmr::vector<CommandBuffer>{ m.swapchainImages.size(), &pmr::g_rsrc };
+    m.commandBuffers = std::pmr::vector<CommandBuffer>{ m.framesInFlight, &pmr::g_persistentArena };
 
 
     for (auto& commandBuffer : m.commandBuffers)
@@ -413,31 +732,36 @@ auto vk::Device::createCommandBuffers() -> void
 
 auto vk::Device::createSyncObjects() -> void
 {
-    m.presentSemaphores = std::pmr::vector<VkSemaphore>{ m.commandBuffers.size(), &pmr::g_rsrc };
-    m.renderSemaphores  = std::pmr::vector<VkSemaphore>{ m.commandBuffers.size(), &pmr::g_rsrc };
-    m.fences = std::pmr::vector<VkFence>{ m.commandBuffers.size(), &pmr::g_rsrc };
+    m.renderSemaphores = std::pmr::vector<VkSemaphore>{ m.framesInFlight, &pmr::g_persistentArena };
+    m.frameValues = std::pmr::vector<u64>{ m.framesInFlight, &pmr::g_persistentArena };
 
     auto const semaphoreCreateInfo{ VkSemaphoreCreateInfo{
         .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
     }};
 
-    auto const fenceCreateInfo{ VkFenceCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-        .flags = VK_FENCE_CREATE_SIGNALED_BIT
-    }};
-
-    for (auto i{ m.presentSemaphores.size() }; i--; )
+    for (auto& semaphore : m.renderSemaphores)
     {
-
-        if (vkCreateSemaphore(m.device, &semaphoreCreateInfo, nullptr, &m.presentSemaphores[i]) ||
-            vkCreateSemaphore(m.device, &semaphoreCreateInfo, nullptr, &m.renderSemaphores[i]))
+        if (vkCreateSemaphore(m.device, &semaphoreCreateInfo, nullptr, &semaphore))
         {
             throw std::runtime_error("Failed to create VkSemaphore");
         }
+    }
 
-        if (vkCreateFence(m.device, &fenceCreateInfo, nullptr, &m.fences[i]))
+    auto const timelineTypeCreateInfo{ VkSemaphoreTypeCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE
+    }};
+
+    auto const timelineCreateInfo{ VkSemaphoreCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &timelineTypeCreateInfo
+    }};
+
+    for (auto& timeline : m.timelines)
+    {
+        if (vkCreateSemaphore(m.device, &timelineCreateInfo, nullptr, &timeline))
         {
-            throw std::runtime_error("Failed to create VkFence");
+            throw std::runtime_error("Failed to create timeline VkSemaphore");
         }
     }
 }
@@ -445,15 +769,7 @@ auto vk::Device::createSyncObjects() -> void
 auto vk::Device::createTransferResources() -> void
 {
     m.transferCommandBuffer.allocate(this);
-
-    auto const fenceCreateInfo{ VkFenceCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
-    }};
-
-    if (vkCreateFence(m.device, &fenceCreateInfo, nullptr, &m.transferFence))
-    {
-        throw std::runtime_error("Failed to create VkFence");
-    }
+    m.uploader = Uploader{ *this, 1024 * 1024 * 16 };
 }
 
 auto vk::Device::createDescriptorPool() -> void
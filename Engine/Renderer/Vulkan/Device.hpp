@@ -1,8 +1,15 @@
 #pragma once
 #include "Image.hpp"
 #include "CommandBuffer.hpp"
+#include "Uploader.hpp"
+#include "DeletionQueue.hpp"
+#include "GpuProfiler.hpp"
 #include "BufferResource.hpp"
+#include "ArrayProxy.hpp"
 #include <functional>
+#include <array>
+#include <span>
+#include <vector>
 
 class Window;
 
@@ -10,7 +17,6 @@ struct VkDevice_T;
 struct VkQueue_T;
 struct VkSwapchainKHR_T;
 struct VkSemaphore_T;
-struct VkFence_T;
 struct VkDescriptorPool_T;
 struct VkSampler_T;
 struct VmaAllocator_T;
@@ -19,7 +25,6 @@ using VkDevice         = VkDevice_T*;
 using VkQueue          = VkQueue_T*;
 using VkSwapchainKHR   = VkSwapchainKHR_T*;
 using VkSemaphore      = VkSemaphore_T*;
-using VkFence          = VkFence_T*;
 using VkDescriptorPool = VkDescriptorPool_T*;
 using VkSampler        = VkSampler_T*;
 using VmaAllocator     = VmaAllocator_T*;
@@ -30,6 +35,13 @@ namespace vk
     class Surface;
     class PhysicalDevice;
 
+    struct SemaphoreSubmit
+    {
+        VkSemaphore        semaphore;
+        u64                value;
+        PipelineStageFlags stage;
+    };
+
     class Device
     {
     public:
@@ -41,7 +53,8 @@ namespace vk
         };
 
     public:
-        Device(Instance& instance, Surface& surface, PhysicalDevice& physicalDevice);
+        Device(Instance& instance, Surface& surface, PhysicalDevice& physicalDevice, u32 framesInFlight = 2);
+        Device(Instance& instance, PhysicalDevice& physicalDevice, glm::uvec2 extent, u32 framesInFlight = 2);
         ~Device();
         Device(Device&& other);
         Device(Device const&) = delete;
@@ -51,8 +64,18 @@ namespace vk
     public:
         auto waitIdle() -> void;
         auto checkSwapchainState(Window& window) -> SwapchainResult;
+        auto beginFrame() -> CommandBuffer&;
         auto submitAndPresent() -> void;
         auto transferSubmit(std::function<void(CommandBuffer&)>&& function) -> void;
+        auto submit(
+            QueueType                   type,
+            CommandBuffer&              commands,
+            ArrayProxy<SemaphoreSubmit> waits   = {},
+            ArrayProxy<SemaphoreSubmit> signals = {}
+        ) -> u64;
+        auto currentGpuValue(QueueType type = QueueType::eGraphics) const -> u64;
+        auto waitGpuValue(QueueType type, u64 value) const -> void;
+        auto readback() -> std::vector<u8>;
 
     public:
         inline operator VkDevice() const noexcept
@@ -60,6 +83,11 @@ namespace vk
             return m.device;
         }
 
+        inline operator VkQueue() const noexcept
+        {
+            return m.queues[static_cast<u32>(QueueType::eGraphics)];
+        }
+
         inline operator VmaAllocator() const noexcept
         {
             return m.allocator;
@@ -81,11 +109,87 @@ namespace vk
             return static_cast<T>(m.frameIndex);
         }
 
+        inline auto getFramesInFlight() const noexcept -> u32
+        {
+            return m.framesInFlight;
+        }
+
+        inline auto getImageIndex() const noexcept -> u32
+        {
+            return m.imageIndex;
+        }
+
+        // Without a surface the swapchain is replaced by one offscreen color target per frame in flight.
+        inline auto isHeadless() const noexcept -> bool
+        {
+            return !m.surface;
+        }
+
         inline auto getExtent() const noexcept -> glm::uvec2
         {
             return m.swapchainExtent;
         }
 
+        inline auto getQueue(QueueType type) const noexcept -> VkQueue
+        {
+            return m.queues[static_cast<u32>(type)];
+        }
+
+        inline auto getQueueFamily(QueueType type) const noexcept -> u32
+        {
+            return m.queueFamilies[static_cast<u32>(type)];
+        }
+
+        inline auto getTimeline(QueueType type) const noexcept -> VkSemaphore
+        {
+            return m.timelines[static_cast<u32>(type)];
+        }
+
+        // Value signalled by the most recent submission to the queue; the work is done once currentGpuValue() reaches it.
+        inline auto signalValue(QueueType type = QueueType::eGraphics) const noexcept -> u64
+        {
+            return m.timelineValues[static_cast<u32>(type)];
+        }
+
+        // True between beginFrame and submitAndPresent, while the frame's commands are being recorded.
+        inline auto isRecording() const noexcept -> bool
+        {
+            return m.recording;
+        }
+
+        // Distinct families behind the queue types; concurrent resources are shared between them.
+        inline auto getUniqueQueueFamilies() const noexcept -> std::span<u32 const>
+        {
+            return { m.uniqueFamilies.data(), m.uniqueFamilyCount };
+        }
+
+        // False when the queue type falls back to the shared graphics queue.
+        inline auto hasDedicatedQueue(QueueType type) const noexcept -> bool
+        {
+            return m.queueFamilies[static_cast<u32>(type)] != m.queueFamilies[static_cast<u32>(QueueType::eGraphics)];
+        }
+
+        // Task and mesh shaders from VK_EXT_mesh_shader, enabled whenever the physical device has them.
+        inline auto hasMeshShader() const noexcept -> bool
+        {
+            return m.meshShader;
+        }
+
+        inline auto getUploader() noexcept -> Uploader&
+        {
+            return m.uploader;
+        }
+
+        inline auto getDeletionQueue() noexcept -> DeletionQueue&
+        {
+            return m.deletionQueue;
+        }
+
+        inline auto getGpuProfiler() noexcept -> GpuProfiler&
+        {
+            return m.gpuProfiler;
+        }
+
         inline auto getCommandBuffers() noexcept -> std::pmr::vector<CommandBuffer>&
         {
             return m.commandBuffers;
@@ -106,6 +210,7 @@ namespace vk
         auto createDevice(Instance& instance)    -> void;
         auto createAllocator(Instance& instance) -> void;
         auto createSwapchain()                   -> void;
+        auto createOffscreenTargets()            -> void;
         auto createCommandBuffers()              -> void;
         auto createSyncObjects()                 -> void;
         auto createTransferResources()           -> void;
@@ -118,24 +223,36 @@ namespace vk
             Surface*         surface;
             PhysicalDevice*  physicalDevice;
             VkDevice         device;
-            VkQueue          queue;
             VkSwapchainKHR   swapchain;
             VkSwapchainKHR   oldSwapchain;
             VkDescriptorPool descriptorPool;
             VkSampler        sampler;
-            VkFence          transferFence;
             CommandBuffer    transferCommandBuffer;
+            Uploader         uploader;
+            DeletionQueue    deletionQueue;
+            GpuProfiler      gpuProfiler;
             VmaAllocator     allocator;
             Format           surfaceFormat;
             glm::uvec2       swapchainExtent;
             u32              imageIndex;
             u32              frameIndex;
+            u32              framesInFlight;
+            bool             pipelineStatistics;
+            bool             meshShader;
+            bool             recording;
+
+            std::array<VkQueue, 3>     queues;
+            std::array<u32, 3>         queueFamilies;
+            std::array<u32, 3>         uniqueFamilies;
+            u32                        uniqueFamilyCount;
+            std::array<VkSemaphore, 3> timelines;
+            std::array<u64, 3>         timelineValues;
 
-            std::pmr::vector<Image>         swapchainImages;
-            std::pmr::vector<CommandBuffer> commandBuffers;
-            std::pmr::vector<VkSemaphore>   presentSemaphores;
-            std::pmr::vector<VkSemaphore>   renderSemaphores;
-            std::pmr::vector<VkFence>       fences;
+            std::pmr::vector<Image>         swapchainImages   { &pmr::g_persistentArena };
+            std::pmr::vector<CommandBuffer> commandBuffers    { &pmr::g_persistentArena };
+            std::pmr::vector<VkSemaphore>   presentSemaphores { &pmr::g_persistentArena };
+            std::pmr::vector<VkSemaphore>   renderSemaphores  { &pmr::g_persistentArena };
+            std::pmr::vector<u64>           frameValues       { &pmr::g_persistentArena };
         } m;  
     };
 }
\ No newline at end of file
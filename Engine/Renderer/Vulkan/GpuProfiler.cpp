@@ -0,0 +1,214 @@
+#include "GpuProfiler.hpp"
+#include "Device.hpp"
+#include "CommandBuffer.hpp"
+#include <volk.h>
+#include <algorithm>
+#include <stdexcept>
+
+static constexpr auto s_statisticFlags{ VkQueryPipelineStatisticFlags{
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT
+}};
+
+vk::GpuProfiler::GpuProfiler()
+    : m{}
+{}
+
+vk::GpuProfiler::GpuProfiler(Device& device, VkPhysicalDevice physicalDevice, u32 framesInFlight, bool pipelineStatistics)
+    : m{
+        .device = &device,
+        .slots = std::make_unique<Slot[]>(framesInFlight),
+        .slotCount = framesInFlight,
+        .pipelineStatistics = pipelineStatistics
+    }
+{
+    auto properties{ VkPhysicalDeviceProperties{} };
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    m.timestampPeriod = static_cast<f64>(properties.limits.timestampPeriod);
+
+    for (auto i{ u32{} }; i < m.slotCount; ++i)
+    {
+        auto& slot{ m.slots[i] };
+
+        auto const timestampCreateInfo{ VkQueryPoolCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = maxZones * 2
+        }};
+
+        if (vkCreateQueryPool(*m.device, &timestampCreateInfo, nullptr, &slot.timestamps))
+        {
+            throw std::runtime_error("Failed to create timestamp VkQueryPool");
+        }
+
+        vkResetQueryPool(*m.device, slot.timestamps, 0, maxZones * 2);
+
+        if (m.pipelineStatistics)
+        {
+            auto const statisticsCreateInfo{ VkQueryPoolCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                .queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+                .queryCount = maxZones,
+                .pipelineStatistics = s_statisticFlags
+            }};
+
+            if (vkCreateQueryPool(*m.device, &statisticsCreateInfo, nullptr, &slot.statistics))
+            {
+                throw std::runtime_error("Failed to create pipeline statistics VkQueryPool");
+            }
+
+            vkResetQueryPool(*m.device, slot.statistics, 0, maxZones);
+        }
+    }
+}
+
+vk::GpuProfiler::~GpuProfiler()
+{
+    for (auto i{ u32{} }; i < m.slotCount; ++i)
+    {
+        vkDestroyQueryPool(*m.device, m.slots[i].timestamps, nullptr);
+        vkDestroyQueryPool(*m.device, m.slots[i].statistics, nullptr);
+    }
+
+    m = {};
+}
+
+vk::GpuProfiler::GpuProfiler(GpuProfiler&& other)
+    : m{ std::move(other.m) }
+{
+    other.m = {};
+}
+
+auto vk::GpuProfiler::operator=(GpuProfiler&& other) -> GpuProfiler&
+{
+    m = std::move(other.m);
+    other.m = {};
+
+    return *this;
+}
+
+// Safe to call from several recording threads at once; each zone claims its own query indices.
+auto vk::GpuProfiler::beginZone(CommandBuffer& commands, u32 frameIndex, char const* name) -> u32
+{
+    if (!m.slotCount)
+    {
+        return noZone;
+    }
+
+    auto& slot{ m.slots[frameIndex % m.slotCount] };
+    auto const zone{ slot.zoneCount.fetch_add(1, std::memory_order_relaxed) };
+
+    if (zone >= maxZones)
+    {
+        return noZone;
+    }
+
+    slot.names[zone] = name;
+    vkCmdWriteTimestamp2(commands, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, slot.timestamps, zone * 2);
+
+    // The counters are all graphics statistics, which other queues cannot query; their zones read zero.
+    if (m.pipelineStatistics && commands.getQueue() == QueueType::eGraphics)
+    {
+        vkCmdBeginQuery(commands, slot.statistics, zone, 0);
+    }
+
+    return zone;
+}
+
+auto vk::GpuProfiler::endZone(CommandBuffer& commands, u32 frameIndex, u32 zone) -> void
+{
+    if (zone == noZone)
+    {
+        return;
+    }
+
+    auto& slot{ m.slots[frameIndex % m.slotCount] };
+
+    if (m.pipelineStatistics && commands.getQueue() == QueueType::eGraphics)
+    {
+        vkCmdEndQuery(commands, slot.statistics, zone);
+    }
+
+    vkCmdWriteTimestamp2(commands, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, slot.timestamps, zone * 2 + 1);
+}
+
+// Called once the slot's last frame has retired, so results are read without VK_QUERY_RESULT_WAIT_BIT.
+// Zones whose queries are still unavailable, e.g. from a frame that was never submitted, are dropped.
+auto vk::GpuProfiler::collect(u32 frameIndex) -> void
+{
+    if (!m.slotCount)
+    {
+        return;
+    }
+
+    auto& slot{ m.slots[frameIndex % m.slotCount] };
+    auto const zoneCount{ std::min(slot.zoneCount.exchange(0, std::memory_order_relaxed), maxZones) };
+
+    if (!zoneCount)
+    {
+        return;
+    }
+
+    auto timestamps{ std::array<std::array<u64, 2>, maxZones * 2>{} };
+    auto statistics{ std::array<std::array<u64, 5>, maxZones>{} };
+
+    vkGetQueryPoolResults(
+        *m.device,
+        slot.timestamps,
+        0,
+        zoneCount * 2,
+        sizeof(timestamps[0]) * zoneCount * 2,
+        timestamps.data(),
+        sizeof(timestamps[0]),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+    );
+
+    if (m.pipelineStatistics)
+    {
+        vkGetQueryPoolResults(
+            *m.device,
+            slot.statistics,
+            0,
+            zoneCount,
+            sizeof(statistics[0]) * zoneCount,
+            statistics.data(),
+            sizeof(statistics[0]),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+        );
+    }
+
+    m.zoneCount = 0;
+
+    for (auto zone{ u32{} }; zone < zoneCount; ++zone)
+    {
+        auto const& begin{ timestamps[zone * 2] };
+        auto const& end  { timestamps[zone * 2 + 1] };
+
+        if (!begin[1] || !end[1])
+        {
+            continue;
+        }
+
+        // The last word is availability; zones recorded off the graphics queue have no counters.
+        auto const counters{ statistics[zone][4] ? statistics[zone] : std::array<u64, 5>{} };
+
+        m.zones[m.zoneCount++] = GpuZone{
+            .name = slot.names[zone],
+            .milliseconds = static_cast<f64>(end[0] - begin[0]) * m.timestampPeriod / 1e6,
+            .vertexInvocations = counters[0],
+            .clippingInvocations = counters[1],
+            .clippingPrimitives = counters[2],
+            .fragmentInvocations = counters[3]
+        };
+    }
+
+    vkResetQueryPool(*m.device, slot.timestamps, 0, zoneCount * 2);
+
+    if (m.pipelineStatistics)
+    {
+        vkResetQueryPool(*m.device, slot.statistics, 0, zoneCount);
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "Types.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <span>
+
+struct VkQueryPool_T;
+struct VkPhysicalDevice_T;
+
+using VkQueryPool      = VkQueryPool_T*;
+using VkPhysicalDevice = VkPhysicalDevice_T*;
+
+namespace vk
+{
+    class Device;
+    class CommandBuffer;
+
+    struct GpuZone
+    {
+        char const* name;
+        f64         milliseconds;
+        u64         vertexInvocations;
+        u64         clippingInvocations;
+        u64         clippingPrimitives;
+        u64         fragmentInvocations;
+    };
+
+    // Timestamp and pipeline-statistics queries, one pool pair per frame in flight. A slot is
+    // read back without waiting when the device reuses it, by which point its frame has retired.
+    class GpuProfiler
+    {
+    public:
+        static constexpr auto maxZones{ 64u };
+        static constexpr auto noZone  { ~0u };
+
+    public:
+        GpuProfiler();
+        GpuProfiler(Device& device, VkPhysicalDevice physicalDevice, u32 framesInFlight, bool pipelineStatistics);
+        ~GpuProfiler();
+        GpuProfiler(GpuProfiler const&) = delete;
+        GpuProfiler(GpuProfiler&& other);
+        auto operator=(GpuProfiler const&)  -> GpuProfiler& = delete;
+        auto operator=(GpuProfiler&& other) -> GpuProfiler&;
+
+    public:
+        auto beginZone(CommandBuffer& commands, u32 frameIndex, char const* name) -> u32;
+        auto endZone(CommandBuffer& commands, u32 frameIndex, u32 zone) -> void;
+        auto collect(u32 frameIndex) -> void;
+
+    public:
+        // Zones of the most recently collected frame, in the order they were recorded.
+        inline auto getZones() const noexcept -> std::span<GpuZone const>
+        {
+            return { m.zones.data(), m.zoneCount };
+        }
+
+        inline auto hasPipelineStatistics() const noexcept -> bool
+        {
+            return m.pipelineStatistics;
+        }
+
+    private:
+        struct Slot
+        {
+            VkQueryPool                       timestamps;
+            VkQueryPool                       statistics;
+            std::array<char const*, maxZones> names;
+            std::atomic<u32>                  zoneCount;
+        };
+
+    private:
+        struct M
+        {
+            Device*                       device;
+            std::unique_ptr<Slot[]>       slots;
+            u32                           slotCount;
+            f64                           timestampPeriod;
+            bool                          pipelineStatistics;
+            std::array<GpuZone, maxZones> zones;
+            u32                           zoneCount;
+        } m;
+    };
+}
@@ -42,14 +42,11 @@ vk::Image::Image(Device* pDevice, glm::uvec2 size, ImageUsageFlags usage, Format
         .size   = size
     };
 
-    switch (usage)
+    // Depth attachments may also be sampled, e.g. to build the depth pyramid.
+    if (usage & ImageUsage::eDepthAttachment)
     {
-    case ImageUsage::eDepthAttachment:
         m.layout = ImageLayout::eDepthAttachment;
         m.aspect = Aspect::eDepth;
-        break;
-    default:
-        break;
     }
 
     auto const imageCreateInfo{ VkImageCreateInfo{
@@ -110,12 +107,12 @@ vk::Image::~Image()
     {
         if (m.imageView)
         {
-            vkDestroyImageView(*m.device, m.imageView, nullptr);
+            m.device->getDeletionQueue().push(m.imageView);
         }
 
         if (m.image && m.allocation)
         {
-            vmaDestroyImage(*m.device, m.image, m.allocation);
+            m.device->getDeletionQueue().push(m.image, m.allocation);
         }
     }
 
@@ -172,88 +169,12 @@ vk::Image::Image(Device* pDevice, VkImage image, Format format, glm::uvec2 size)
     }
 }
 
-auto vk::Image::write(void const* data, size_t dataSize) -> void
+auto vk::Image::write(void const* data, size_t dataSize) -> UploadToken
 {
-    auto const bufferCreateInfo{ VkBufferCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size = dataSize,
-        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-    }};
-
-    auto const allocationCreateInfo{ VmaAllocationCreateInfo{
-        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-                 VMA_ALLOCATION_CREATE_MAPPED_BIT,
-        .usage = VMA_MEMORY_USAGE_AUTO,
-    }};
-
-    auto stagingBuffer{ VkBuffer{} };
-    auto stagingAllocation{ VmaAllocation{} };
-    auto allocationInfo{ VmaAllocationInfo{} };
-
-    if (vmaCreateBuffer(*m.device, &bufferCreateInfo, &allocationCreateInfo, &stagingBuffer, &stagingAllocation, &allocationInfo))
-    {
-        throw std::runtime_error("Failed to allocate buffer");
-    }
-
-    std::memcpy(allocationInfo.pMappedData, data, dataSize);
-    vmaFlushAllocation(*m.device, m.allocation, 0, dataSize);
-
-    auto const copy{ VkBufferImageCopy{
-        .imageSubresource = {
-            .aspectMask = m.aspect,
-            .layerCount = 1
-        },
-        .imageExtent = {
-            .width = m.size.x,
-            .height = m.size.y,
-            .depth = 1
-        }
-    }};
-
-    auto barrier{ VkImageMemoryBarrier2{
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
-        .srcAccessMask = VK_QUEUE_FAMILY_IGNORED,
-        .dstAccessMask = VK_QUEUE_FAMILY_IGNORED,
-        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        .image = m.image,
-        .subresourceRange = {
-            .aspectMask = m.aspect,
-            .levelCount = 1,
-            .layerCount = 1
-        }
-    }};
-
-    auto const dependency{ VkDependencyInfo{
-        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-        .imageMemoryBarrierCount = 1,
-        .pImageMemoryBarriers = &barrier
-    }};
-
-    m.device->transferSubmit([&](CommandBuffer& command)
-    {
-        barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
-        barrier.dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        barrier.srcAccessMask = VK_ACCESS_2_NONE;
-        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-
-        vkCmdPipelineBarrier2(command, &dependency);
-
-        vkCmdCopyBufferToImage(command, stagingBuffer, m.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
-    
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-        barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
-        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
-
-        vkCmdPipelineBarrier2(command, &dependency);
-    });
-
-    vmaDestroyBuffer(*m.device, stagingBuffer, stagingAllocation);
+    return m.device->getUploader().upload(data, dataSize, *this, {}, m.size);
 }
 
-auto vk::Image::subwrite(void const *data, size_t dataSize, glm::ivec2 offset, glm::uvec2 size) -> void
+auto vk::Image::subwrite(void const* data, size_t dataSize, glm::ivec2 offset, glm::uvec2 size) -> UploadToken
 {
+    return m.device->getUploader().upload(data, dataSize, *this, offset, size);
 }
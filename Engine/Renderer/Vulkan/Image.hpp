@@ -1,6 +1,7 @@
 #pragma once
 #include "Types.hpp"
 #include "VulkanEnums.hpp"
+#include "Uploader.hpp"
 #include <glm/glm.hpp>
 #include <string_view>
 
@@ -29,8 +30,8 @@ namespace vk
         auto operator=(Image&& other) -> Image&;
 
     public:
-        auto write(void const* data, size_t dataSize) -> void;
-        auto subwrite(void const* data, size_t dataSize, glm::ivec2 offset, glm::uvec2 size) -> void;
+        auto write(void const* data, size_t dataSize) -> UploadToken;
+        auto subwrite(void const* data, size_t dataSize, glm::ivec2 offset, glm::uvec2 size) -> UploadToken;
 
     private:
         friend class Device;
@@ -19,7 +19,7 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
     return VK_FALSE;
 }
 
-vk::Instance::Instance(bool validationLayersEnabled)
+vk::Instance::Instance(bool validationLayersEnabled, bool surfaceExtensions)
     : m{}
 {
     if (volkInitialize())
@@ -29,12 +29,17 @@ vk::Instance::Instance(bool validationLayersEnabled)
 
     spdlog::info("Loaded Vulkan functions");
 
-    auto extensionCount{ u32{} };
-    auto extensionNames{ SDL_Vulkan_GetInstanceExtensions(&extensionCount) };
-
-    auto extensions{ std::vector<char const*>{extensionNames, extensionNames + extensionCount} };
+    auto extensions{ std::vector<char const*>{} };
     auto layers    { std::vector<char const*>{} };
 
+    if (surfaceExtensions)
+    {
+        auto extensionCount{ u32{} };
+        auto extensionNames{ SDL_Vulkan_GetInstanceExtensions(&extensionCount) };
+
+        extensions.assign(extensionNames, extensionNames + extensionCount);
+    }
+
     if (vkEnumerateInstanceVersion(&m.apiVersion))
     {
         throw std::runtime_error("Failed to enumerate instance version");
@@ -12,7 +12,7 @@ namespace vk
     {
     public:
         Instance() = default;
-        Instance(bool validationLayersEnabled);
+        Instance(bool validationLayersEnabled, bool surfaceExtensions = true);
         ~Instance();
         Instance(Instance&& other);
         Instance(Instance const&) = delete;
@@ -39,8 +39,9 @@ vk::PhysicalDevice::PhysicalDevice(Instance& instance)
         if (!vulkan_1_3Features.dynamicRendering)                  continue;
 
         m.physicalDevice = currentPhysicalDevice;
+        m.meshShader = meshShaderFeatures.taskShader && meshShaderFeatures.meshShader;
 
-        if (meshShaderFeatures.meshShader) break;
+        if (m.meshShader) break;
     }
 
     if (!m.physicalDevice)
@@ -61,6 +62,7 @@ vk::PhysicalDevice::PhysicalDevice(Instance& instance)
         VK_VERSION_MINOR(properties.properties.apiVersion),
         VK_VERSION_PATCH(properties.properties.apiVersion)
     );
+    spdlog::info("Graphics card mesh shaders [ {} ]", m.meshShader);
 }
 
 vk::PhysicalDevice::PhysicalDevice(PhysicalDevice&& other)
@@ -24,10 +24,16 @@ namespace vk
             return m.physicalDevice;
         }
 
+        inline auto hasMeshShader() const noexcept -> bool
+        {
+            return m.meshShader;
+        }
+
     private:
         struct M
         {
             VkPhysicalDevice physicalDevice;
+            bool             meshShader;
         } m;
     };
 }
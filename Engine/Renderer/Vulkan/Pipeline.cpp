@@ -1,6 +1,7 @@
 #include "Pipeline.hpp"
 #include "Device.hpp"
 #include "Buffer.hpp"
+#include "BufferResource.hpp"
 #include <volk.h>
 #include <array>
 #include <vector>
@@ -21,14 +22,21 @@ vk::Pipeline::Pipeline(Device& device, Config const& config)
         .point = config.point
     }
 {
+    auto scratch{ pmr::ScratchScope{} };
+
+    if (config.point == BindPoint::eCompute && (config.stages.size() != 1 || config.stages.begin()->stage != ShaderStage::eCompute))
+    {
+        throw std::runtime_error("Failed to create compute pipeline: expected exactly one compute stage");
+    }
+
     if (!config.descriptors.empty())
     {
-        m.sets.resize(m.device->getCommandBuffers().size());
+        m.sets.resize(m.device->getFramesInFlight());
 
-        auto bindings{ std::vector<VkDescriptorSetLayoutBinding>(config.descriptors.size()) };
-        auto bindingFlags{ std::vector<VkDescriptorBindingFlags>(config.descriptors.size()) };
-        auto writes{ std::vector<VkWriteDescriptorSet>{} }; writes.reserve(config.descriptors.size());
-        auto bufferInfos{ std::deque<VkDescriptorBufferInfo>{} };
+        auto bindings{ std::pmr::vector<VkDescriptorSetLayoutBinding>(config.descriptors.size(), scratch.get()) };
+        auto bindingFlags{ std::pmr::vector<VkDescriptorBindingFlags>(config.descriptors.size(), scratch.get()) };
+        auto writes{ std::pmr::vector<VkWriteDescriptorSet>{ scratch.get() } }; writes.reserve(config.descriptors.size());
+        auto bufferInfos{ std::pmr::deque<VkDescriptorBufferInfo>{ scratch.get() } };
 
         for (auto i{ config.descriptors.size() }; i--; )
         {
@@ -138,8 +146,13 @@ vk::Pipeline::Pipeline(Device& device, Config const& config)
         }
     }
     {
+        for (auto const& stage : config.stages)
+        {
+            m.pushConstantStages |= config.usePushConstant ? stage.stage : 0u;
+        }
+
         auto const pushConstantRange{ VkPushConstantRange{
-            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+            .stageFlags = m.pushConstantStages,
             .size = 128
         }};
 
@@ -157,8 +170,8 @@ vk::Pipeline::Pipeline(Device& device, Config const& config)
         }
     }
     {
-        auto shaderStageCreateInfos{ std::vector<VkPipelineShaderStageCreateInfo>{config.stages.size()} };
-        auto shaderModules{ std::vector<VkShaderModule>{config.stages.size()} };
+        auto shaderStageCreateInfos{ std::pmr::vector<VkPipelineShaderStageCreateInfo>(config.stages.size(), scratch.get()) };
+        auto shaderModules{ std::pmr::vector<VkShaderModule>(config.stages.size(), scratch.get()) };
 
         for (auto i{ config.stages.size() }; i--; )
         {
@@ -189,93 +202,109 @@ vk::Pipeline::Pipeline(Device& device, Config const& config)
             };
         }
 
-        auto constexpr dynamicStates{ std::array{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR} };
+        if (config.point == BindPoint::eCompute)
+        {
+            auto const pipelineCreateInfo{ VkComputePipelineCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                .stage = shaderStageCreateInfos.front(),
+                .layout = m.layout
+            }};
 
-        auto const dynamicStateCreateInfo{ VkPipelineDynamicStateCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-            .dynamicStateCount = static_cast<u32>(dynamicStates.size()),
-            .pDynamicStates = dynamicStates.data()
-        }};
+            if (vkCreateComputePipelines(*m.device, nullptr, 1, &pipelineCreateInfo, nullptr, &m.pipeline))
+            {
+                throw std::runtime_error("Failed to create VkPipeline");
+            }
+        }
+        else
+        {
+            auto constexpr dynamicStates{ std::array{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR} };
 
-        auto const viewportStateCreateInfo{ VkPipelineViewportStateCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
-            .viewportCount = 1,
-            .scissorCount  = 1
-        }};
+            auto const dynamicStateCreateInfo{ VkPipelineDynamicStateCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+                .dynamicStateCount = static_cast<u32>(dynamicStates.size()),
+                .pDynamicStates = dynamicStates.data()
+            }};
 
-        auto const inputAssemblyStateCreateInfo{ VkPipelineInputAssemblyStateCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-            .topology = static_cast<VkPrimitiveTopology>(config.topology)
-        }};
+            auto const viewportStateCreateInfo{ VkPipelineViewportStateCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+                .viewportCount = 1,
+                .scissorCount  = 1
+            }};
 
-        auto const rasterizationStateCreateInfo{ VkPipelineRasterizationStateCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
-            .cullMode = static_cast<VkCullModeFlags>(config.cullMode),
-            .frontFace = VK_FRONT_FACE_CLOCKWISE,
-            .lineWidth = 1.0f,
-        }};
+            auto const inputAssemblyStateCreateInfo{ VkPipelineInputAssemblyStateCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+                .topology = static_cast<VkPrimitiveTopology>(config.topology)
+            }};
 
-        auto const multisampleStateCreateInfo{ VkPipelineMultisampleStateCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-            .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
-        }};
+            auto const rasterizationStateCreateInfo{ VkPipelineRasterizationStateCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+                .cullMode = static_cast<VkCullModeFlags>(config.cullMode),
+                .frontFace = VK_FRONT_FACE_CLOCKWISE,
+                .lineWidth = 1.0f,
+            }};
 
-        auto const blendAttachmentState{ VkPipelineColorBlendAttachmentState{
-            .blendEnable = config.colorBlending,
-            .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
-            .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
-            .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
-            .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
-        }};
+            auto const multisampleStateCreateInfo{ VkPipelineMultisampleStateCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+                .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+            }};
 
-        auto const colorBlendStateCreateInfo{ VkPipelineColorBlendStateCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-            .logicOp = VK_LOGIC_OP_COPY,
-            .attachmentCount = 1,
-            .pAttachments = &blendAttachmentState
-        }};
+            auto const blendAttachmentState{ VkPipelineColorBlendAttachmentState{
+                .blendEnable = config.colorBlending,
+                .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+                .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+                .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+                .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+            }};
 
-        auto const depthStencilStateCreateInfo{ VkPipelineDepthStencilStateCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-            .depthTestEnable = config.depthTest,
-            .depthWriteEnable = config.depthWrite,
-            .depthCompareOp = VK_COMPARE_OP_LESS,
-            .stencilTestEnable = false
-        }};
+            auto const colorBlendStateCreateInfo{ VkPipelineColorBlendStateCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+                .logicOp = VK_LOGIC_OP_COPY,
+                .attachmentCount = 1,
+                .pAttachments = &blendAttachmentState
+            }};
 
-        auto const vertexInputStateCreateInfo{ VkPipelineVertexInputStateCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO
-        }};
+            auto const depthStencilStateCreateInfo{ VkPipelineDepthStencilStateCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+                .depthTestEnable = config.depthTest,
+                .depthWriteEnable = config.depthWrite,
+                .depthCompareOp = VK_COMPARE_OP_LESS,
+                .stencilTestEnable = false
+            }};
 
-        auto const colorFormat{ static_cast<VkFormat>(m.device->getSurfaceFormat()) };
+            auto const vertexInputStateCreateInfo{ VkPipelineVertexInputStateCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO
+            }};
 
-        auto const renderingCreateInfo{ VkPipelineRenderingCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
-            .colorAttachmentCount = 1,
-            .pColorAttachmentFormats = &colorFormat,
-            .depthAttachmentFormat = VK_FORMAT_D32_SFLOAT,
-            .stencilAttachmentFormat = VK_FORMAT_UNDEFINED
-        }};
+            auto const colorFormat{ static_cast<VkFormat>(m.device->getSurfaceFormat()) };
 
-        auto const pipelineCreateInfo{ VkGraphicsPipelineCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-            .pNext = (void*)&renderingCreateInfo,
-            .stageCount = static_cast<u32>(shaderStageCreateInfos.size()),
-            .pStages = shaderStageCreateInfos.data(),
-            .pVertexInputState = &vertexInputStateCreateInfo,
-            .pInputAssemblyState = &inputAssemblyStateCreateInfo,
-            .pViewportState = &viewportStateCreateInfo,
-            .pRasterizationState = &rasterizationStateCreateInfo,
-            .pMultisampleState = &multisampleStateCreateInfo,
-            .pDepthStencilState = &depthStencilStateCreateInfo,
-            .pColorBlendState = &colorBlendStateCreateInfo,
-            .pDynamicState = &dynamicStateCreateInfo,
-            .layout = m.layout
-        }};
+            auto const renderingCreateInfo{ VkPipelineRenderingCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+                .colorAttachmentCount = 1,
+                .pColorAttachmentFormats = &colorFormat,
+                .depthAttachmentFormat = VK_FORMAT_D32_SFLOAT,
+                .stencilAttachmentFormat = VK_FORMAT_UNDEFINED
+            }};
 
-        if (vkCreateGraphicsPipelines(*m.device, nullptr, 1, &pipelineCreateInfo, nullptr, &m.pipeline))
-        {
-            throw std::runtime_error("Failed to create VkPipeline");
+            auto const pipelineCreateInfo{ VkGraphicsPipelineCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                .pNext = (void*)&renderingCreateInfo,
+                .stageCount = static_cast<u32>(shaderStageCreateInfos.size()),
+                .pStages = shaderStageCreateInfos.data(),
+                .pVertexInputState = &vertexInputStateCreateInfo,
+                .pInputAssemblyState = &inputAssemblyStateCreateInfo,
+                .pViewportState = &viewportStateCreateInfo,
+                .pRasterizationState = &rasterizationStateCreateInfo,
+                .pMultisampleState = &multisampleStateCreateInfo,
+                .pDepthStencilState = &depthStencilStateCreateInfo,
+                .pColorBlendState = &colorBlendStateCreateInfo,
+                .pDynamicState = &dynamicStateCreateInfo,
+                .layout = m.layout
+            }};
+
+            if (vkCreateGraphicsPipelines(*m.device, nullptr, 1, &pipelineCreateInfo, nullptr, &m.pipeline))
+            {
+                throw std::runtime_error("Failed to create VkPipeline");
+            }
         }
 
         for (auto shaderModule : shaderModules)
@@ -294,13 +323,13 @@ vk::Pipeline::~Pipeline()
     {
         if (m.setLayout)
         {
-            vkDestroyDescriptorSetLayout(*m.device, m.setLayout, nullptr);
+            m.device->getDeletionQueue().push(m.setLayout);
         }
 
         if (m.pipeline && m.layout)
         {
-            vkDestroyPipeline(*m.device, m.pipeline, nullptr);
-            vkDestroyPipelineLayout(*m.device, m.layout, nullptr);
+            m.device->getDeletionQueue().push(m.pipeline);
+            m.device->getDeletionQueue().push(m.layout);
         }
     }
 
@@ -347,6 +376,72 @@ auto vk::Pipeline::writeImage(Image& image, u32 element, DescriptorType type) ->
     image.setLayout(vk::ImageLayout::eUndefined);
 }
 
+auto vk::Pipeline::writeImage(Image& image, u32 element, DescriptorType type, u32 frameIndex) -> void
+{
+    auto const imageInfo{ VkDescriptorImageInfo{
+        .sampler = *m.device,
+        .imageView = image,
+        .imageLayout = static_cast<VkImageLayout>(image.getLayout()),
+    }};
+
+    auto const write{ VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = m.sets[frameIndex],
+        .dstBinding = m.imagesBinding,
+        .dstArrayElement = element,
+        .descriptorCount = 1,
+        .descriptorType = static_cast<VkDescriptorType>(type),
+        .pImageInfo = &imageInfo
+    }};
+
+    vkUpdateDescriptorSets(*m.device, 1, &write, 0, nullptr);
+
+    image.setLayout(vk::ImageLayout::eUndefined);
+}
+
+// For images sampled in a layout they are only moved to later in the frame; the tracked layout is
+// left as it is.
+auto vk::Pipeline::writeImage(Image& image, ImageLayout layout, u32 element, DescriptorType type, u32 frameIndex) -> void
+{
+    auto const imageInfo{ VkDescriptorImageInfo{
+        .sampler = *m.device,
+        .imageView = image,
+        .imageLayout = static_cast<VkImageLayout>(layout),
+    }};
+
+    auto const write{ VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = m.sets[frameIndex],
+        .dstBinding = m.imagesBinding,
+        .dstArrayElement = element,
+        .descriptorCount = 1,
+        .descriptorType = static_cast<VkDescriptorType>(type),
+        .pImageInfo = &imageInfo
+    }};
+
+    vkUpdateDescriptorSets(*m.device, 1, &write, 0, nullptr);
+}
+
+// Points one frame slot's binding at a recreated buffer; the slot must not be in flight.
+auto vk::Pipeline::writeBuffer(Buffer& buffer, u32 binding, DescriptorType type, u32 frameIndex) -> void
+{
+    auto const bufferInfo{ VkDescriptorBufferInfo{
+        .buffer = buffer,
+        .range = ~0ull
+    }};
+
+    auto const write{ VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = m.sets[frameIndex],
+        .dstBinding = binding,
+        .descriptorCount = 1,
+        .descriptorType = static_cast<VkDescriptorType>(type),
+        .pBufferInfo = &bufferInfo
+    }};
+
+    vkUpdateDescriptorSets(*m.device, 1, &write, 0, nullptr);
+}
+
 static auto readFile(std::string_view filepath) -> std::vector<char>
 {
     auto file{ std::ifstream{filepath.data(), std::ios::ate | std::ios::binary} };
@@ -87,6 +87,9 @@ namespace vk
 
     public:
         auto writeImage(Image& image, u32 element, DescriptorType type) -> void;
+        auto writeImage(Image& image, u32 element, DescriptorType type, u32 frameIndex) -> void;
+        auto writeImage(Image& image, ImageLayout layout, u32 element, DescriptorType type, u32 frameIndex) -> void;
+        auto writeBuffer(Buffer& buffer, u32 binding, DescriptorType type, u32 frameIndex) -> void;
 
     public:
         inline operator VkPipeline() const noexcept
@@ -110,6 +113,12 @@ namespace vk
             return m.point;
         }
 
+        // Every stage of the pipeline sees the push constant range.
+        inline auto getPushConstantStages() const noexcept -> ShaderStageFlags
+        {
+            return m.pushConstantStages;
+        }
+
     private:
         struct M
         {
@@ -120,6 +129,7 @@ namespace vk
             VkDescriptorSetLayout        setLayout;
             BindPoint                    point;
             u32                          imagesBinding;
+            ShaderStageFlags             pushConstantStages;
         } m;
     };
 }
\ No newline at end of file
@@ -0,0 +1,390 @@
+#include "Uploader.hpp"
+#include "Device.hpp"
+#include "Image.hpp"
+#include <volk.h>
+#include <vk_mem_alloc.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+vk::Uploader::Uploader()
+    : m{}
+{}
+
+vk::Uploader::Uploader(Device& device, size_t capacity)
+    : m{
+        .device = &device,
+        .capacity = capacity,
+        .dedicated = device.hasDedicatedQueue(QueueType::eTransfer)
+    }
+{
+    auto const bufferCreateInfo{ VkBufferCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = m.capacity,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+    }};
+
+    auto const allocationCreateInfo{ VmaAllocationCreateInfo{
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                 VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO,
+    }};
+
+    auto allocationInfo{ VmaAllocationInfo{} };
+
+    if (vmaCreateBuffer(*m.device, &bufferCreateInfo, &allocationCreateInfo, &m.buffer, &m.allocation, &allocationInfo))
+    {
+        throw std::runtime_error("Failed to allocate staging buffer");
+    }
+
+    m.mappedData = static_cast<u8*>(allocationInfo.pMappedData);
+
+    for (auto& batch : m.batches)
+    {
+        batch.graphicsCommands.allocate(m.device, QueueType::eGraphics);
+
+        if (m.dedicated)
+        {
+            batch.transferCommands.allocate(m.device, QueueType::eTransfer);
+        }
+    }
+}
+
+vk::Uploader::~Uploader()
+{
+    if (m.device)
+    {
+        this->wait(this->flush());
+
+        for (auto& batch : m.batches)
+        {
+            batch.transferCommands.~CommandBuffer();
+            batch.graphicsCommands.~CommandBuffer();
+        }
+
+        if (m.buffer && m.allocation)
+        {
+            vmaDestroyBuffer(*m.device, m.buffer, m.allocation);
+        }
+    }
+
+    m = {};
+}
+
+vk::Uploader::Uploader(Uploader&& other)
+    : m{ std::move(other.m) }
+{
+    other.m = {};
+}
+
+auto vk::Uploader::operator=(Uploader&& other) -> Uploader&
+{
+    m = std::move(other.m);
+    other.m = {};
+
+    return *this;
+}
+
+auto vk::Uploader::upload(void const* data, size_t size, VkBuffer buffer, size_t offset, SharingMode sharing) -> UploadToken
+{
+    auto const chunkLimit{ m.capacity / batchCount };
+
+    for (auto done{ size_t{} }; done < size; )
+    {
+        auto const chunk{ std::min(size - done, chunkLimit) };
+        auto const stagingOffset{ this->reserve(chunk) };
+
+        std::memcpy(m.mappedData + stagingOffset, static_cast<u8 const*>(data) + done, chunk);
+
+        auto const copy{ VkBufferCopy{
+            .srcOffset = stagingOffset,
+            .dstOffset = offset + done,
+            .size = chunk
+        }};
+
+        auto& batch{ this->current() };
+        vkCmdCopyBuffer(this->copyCommands(batch), m.buffer, buffer, 1, &copy);
+
+        // Both halves go into the same batch, and the graphics half only runs once the transfer
+        // timeline has passed it.
+        if (sharing == SharingMode::eExclusive)
+        {
+            this->copyCommands(batch).transferOwnership(buffer, QueueType::eTransfer, QueueType::eGraphics, copy.dstOffset, copy.size);
+            batch.graphicsCommands.transferOwnership(buffer, QueueType::eTransfer, QueueType::eGraphics, copy.dstOffset, copy.size);
+        }
+
+        done += chunk;
+    }
+
+    return m.lastToken;
+}
+
+auto vk::Uploader::upload(void const* data, size_t size, Image& image, glm::ivec2 offset, glm::uvec2 extent) -> UploadToken
+{
+    auto const rowSize{ extent.y ? size / extent.y : 0 };
+
+    // An empty region, or less than a byte per row, has nothing to copy.
+    if (!extent.x || !rowSize)
+    {
+        return m.lastToken;
+    }
+
+    auto const rowsPerChunk{ std::max<size_t>(m.capacity / batchCount / rowSize, 1) };
+    auto const wholeImage{ offset == glm::ivec2{} && extent == image.getSize() };
+    auto const viaTransfer{ m.dedicated && wholeImage };
+
+    auto barrier{ VkImageMemoryBarrier2{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .srcStageMask = viaTransfer ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+        .srcAccessMask = viaTransfer ? VK_ACCESS_2_NONE : VK_ACCESS_2_SHADER_READ_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+        .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        .oldLayout = wholeImage ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = {
+            .aspectMask = image.getAspect(),
+            .levelCount = 1,
+            .layerCount = 1
+        }
+    }};
+
+    auto const dependency{ VkDependencyInfo{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .imageMemoryBarrierCount = 1,
+        .pImageMemoryBarriers = &barrier
+    }};
+
+    for (auto row{ u32{} }; row < extent.y; )
+    {
+        auto const rows{ static_cast<u32>(std::min<size_t>(extent.y - row, rowsPerChunk)) };
+        auto const stagingOffset{ this->reserve(rows * rowSize) };
+        auto& batch{ this->current() };
+        auto& command{ viaTransfer ? this->copyCommands(batch) : batch.graphicsCommands };
+
+        if (row == 0)
+        {
+            vkCmdPipelineBarrier2(command, &dependency);
+        }
+
+        std::memcpy(m.mappedData + stagingOffset, static_cast<u8 const*>(data) + row * rowSize, rows * rowSize);
+
+        auto const copy{ VkBufferImageCopy{
+            .bufferOffset = stagingOffset,
+            .imageSubresource = {
+                .aspectMask = image.getAspect(),
+                .layerCount = 1
+            },
+            .imageOffset = {
+                .x = offset.x,
+                .y = offset.y + static_cast<i32>(row)
+            },
+            .imageExtent = {
+                .width = extent.x,
+                .height = rows,
+                .depth = 1
+            }
+        }};
+
+        vkCmdCopyBufferToImage(command, m.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+        row += rows;
+    }
+
+    auto& batch{ this->current() };
+
+    if (viaTransfer)
+    {
+        this->copyCommands(batch).transferOwnership(image, QueueType::eTransfer, QueueType::eGraphics, ImageLayout::eTransferDst, ImageLayout::eShaderRead);
+        batch.graphicsCommands.transferOwnership(image, QueueType::eTransfer, QueueType::eGraphics, ImageLayout::eTransferDst, ImageLayout::eShaderRead);
+
+        return m.lastToken;
+    }
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier2(batch.graphicsCommands, &dependency);
+
+    return m.lastToken;
+}
+
+auto vk::Uploader::flush() -> UploadToken
+{
+    if (!m.recording)
+    {
+        return m.lastToken;
+    }
+
+    auto& batch{ m.batches[m.recordIndex] };
+
+    auto const memoryBarrier{ VkMemoryBarrier2{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+        .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT
+    }};
+
+    auto const dependency{ VkDependencyInfo{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &memoryBarrier
+    }};
+
+    vkCmdPipelineBarrier2(batch.graphicsCommands, &dependency);
+    batch.graphicsCommands.end();
+
+    vmaFlushAllocation(*m.device, m.allocation, 0, VK_WHOLE_SIZE);
+
+    if (batch.transferUsed)
+    {
+        batch.transferCommands.end();
+
+        auto const transferDone{ SemaphoreSubmit{
+            .semaphore = m.device->getTimeline(QueueType::eTransfer),
+            .value = m.device->submit(QueueType::eTransfer, batch.transferCommands),
+            .stage = PipelineStage::eAllCommands
+        }};
+
+        batch.gpuValue = m.device->submit(QueueType::eGraphics, batch.graphicsCommands, transferDone);
+    }
+    else
+    {
+        batch.gpuValue = m.device->submit(QueueType::eGraphics, batch.graphicsCommands);
+    }
+
+    batch.submitted = true;
+    m.recording = false;
+    m.recordIndex = (m.recordIndex + 1) % batchCount;
+
+    return batch.token;
+}
+
+auto vk::Uploader::poll(UploadToken token) -> bool
+{
+    this->retire(false, token);
+    return token <= m.completed;
+}
+
+auto vk::Uploader::wait(UploadToken token) -> void
+{
+    if (m.recording && token == m.lastToken)
+    {
+        this->flush();
+    }
+
+    this->retire(true, token);
+}
+
+auto vk::Uploader::current() -> Batch&
+{
+    auto& batch{ m.batches[m.recordIndex] };
+
+    if (!m.recording)
+    {
+        if (batch.submitted)
+        {
+            this->retire(true, batch.token);
+        }
+
+        batch.token = ++m.lastToken;
+        batch.consumed = 0;
+        batch.transferUsed = false;
+        batch.graphicsCommands.begin();
+        m.recording = true;
+    }
+
+    return batch;
+}
+
+auto vk::Uploader::copyCommands(Batch& batch) -> CommandBuffer&
+{
+    if (!m.dedicated)
+    {
+        return batch.graphicsCommands;
+    }
+
+    if (!batch.transferUsed)
+    {
+        batch.transferCommands.begin();
+        batch.transferUsed = true;
+    }
+
+    return batch.transferCommands;
+}
+
+auto vk::Uploader::reserve(size_t size) -> size_t
+{
+    constexpr auto alignment{ size_t{16} };
+
+    while (true)
+    {
+        auto& batch{ this->current() };
+
+        auto const aligned{ (m.head + alignment - 1) & ~(alignment - 1) };
+        auto const wraps  { aligned + size > m.capacity };
+        auto const offset { wraps ? size_t{} : aligned };
+        auto const consumed{ (wraps ? m.capacity - m.head : aligned - m.head) + size };
+
+        if (m.used + consumed <= m.capacity)
+        {
+            m.head = offset + size;
+            m.used += consumed;
+            batch.consumed += consumed;
+
+            return offset;
+        }
+
+        if (batch.consumed)
+        {
+            this->flush();
+        }
+
+        auto const& oldest{ m.batches[m.retireIndex] };
+
+        if (!oldest.submitted)
+        {
+            throw std::runtime_error("Upload does not fit into the staging ring");
+        }
+
+        this->retire(true, oldest.token);
+    }
+}
+
+auto vk::Uploader::retire(bool block, UploadToken token) -> void
+{
+    while (m.completed < token)
+    {
+        auto& batch{ m.batches[m.retireIndex] };
+
+        if (!batch.submitted)
+        {
+            break;
+        }
+
+        if (block)
+        {
+            m.device->waitGpuValue(QueueType::eGraphics, batch.gpuValue);
+        }
+        else if (m.device->currentGpuValue(QueueType::eGraphics) < batch.gpuValue)
+        {
+            break;
+        }
+
+        batch.submitted = false;
+        m.used -= batch.consumed;
+        m.completed = batch.token;
+        m.retireIndex = (m.retireIndex + 1) % batchCount;
+    }
+
+    if (!m.used)
+    {
+        m.head = 0;
+    }
+}
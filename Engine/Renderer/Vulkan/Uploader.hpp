@@ -0,0 +1,82 @@
+#pragma once
+#include "Types.hpp"
+#include "CommandBuffer.hpp"
+#include <glm/glm.hpp>
+#include <array>
+
+struct VkBuffer_T;
+struct VmaAllocation_T;
+
+using VkBuffer      = VkBuffer_T*;
+using VmaAllocation = VmaAllocation_T*;
+
+namespace vk
+{
+    class Device;
+    class Image;
+
+    // Identifies the batch an upload was recorded into. Zero is always complete.
+    using UploadToken = u64;
+
+    // Persistent staging ring. Copies are recorded into the open batch and submitted together
+    // on flush(), so many writes cost one submission and no per-upload staging allocations.
+    // With a dedicated transfer queue the copies run there and ownership is handed back to
+    // the graphics queue, which waits on the transfer timeline before acquiring it. Concurrent
+    // buffers skip the hand-over; the wait alone makes the copies visible.
+    class Uploader
+    {
+    public:
+        Uploader();
+        Uploader(Device& device, size_t capacity);
+        ~Uploader();
+        Uploader(Uploader const&) = delete;
+        Uploader(Uploader&& other);
+        auto operator=(Uploader const&)  -> Uploader& = delete;
+        auto operator=(Uploader&& other) -> Uploader&;
+
+    public:
+        auto upload(void const* data, size_t size, VkBuffer buffer, size_t offset = 0, SharingMode sharing = SharingMode::eExclusive) -> UploadToken;
+        auto upload(void const* data, size_t size, Image& image, glm::ivec2 offset, glm::uvec2 extent) -> UploadToken;
+        auto flush() -> UploadToken;
+        auto poll(UploadToken token) -> bool;
+        auto wait(UploadToken token) -> void;
+
+    private:
+        struct Batch
+        {
+            CommandBuffer transferCommands;
+            CommandBuffer graphicsCommands;
+            UploadToken   token;
+            u64           gpuValue;
+            size_t        consumed;
+            bool          transferUsed;
+            bool          submitted;
+        };
+
+        auto current() -> Batch&;
+        auto copyCommands(Batch& batch) -> CommandBuffer&;
+        auto reserve(size_t size) -> size_t;
+        auto retire(bool block, UploadToken token) -> void;
+
+    private:
+        static constexpr auto batchCount{ 4u };
+
+        struct M
+        {
+            std::array<Batch, batchCount> batches;
+            Device*                       device;
+            VkBuffer                      buffer;
+            VmaAllocation                 allocation;
+            u8*                           mappedData;
+            size_t                        capacity;
+            size_t                        head;
+            size_t                        used;
+            UploadToken                   lastToken;
+            UploadToken                   completed;
+            u32                           recordIndex;
+            u32                           retireIndex;
+            bool                          dedicated;
+            bool                          recording;
+        } m;
+    };
+}
@@ -6,6 +6,8 @@ namespace vk
     using BufferUsageFlags = unsigned;
     using AspectFlags      = unsigned;
     using ShaderStageFlags = unsigned;
+    using PipelineStageFlags = unsigned long long;
+    using AccessFlags        = unsigned long long;
 
     enum class Format : unsigned
     {
@@ -57,6 +59,19 @@ namespace vk
         eStorageBuffer        = 0x00000007
     };
 
+    enum class QueueType : unsigned
+    {
+        eGraphics = 0x00000000,
+        eCompute  = 0x00000001,
+        eTransfer = 0x00000002
+    };
+
+    enum class CommandBufferLevel : unsigned
+    {
+        ePrimary   = 0x00000000,
+        eSecondary = 0x00000001
+    };
+
     enum class MemoryType : unsigned
     {
         eHost     = 0x00000000,
@@ -64,10 +79,17 @@ namespace vk
         eDevice   = 0x00000002
     };
 
+    enum class SharingMode : unsigned
+    {
+        eExclusive  = 0x00000000,
+        eConcurrent = 0x00000001
+    };
+
     namespace ImageUsage
     {
         enum : unsigned
         {
+            eTransferSrc     = 0x00000001,
             eSampled         = 0x00000004,
             eStorage         = 0x00000008,
             eColorAttachment = 0x00000010,
@@ -79,6 +101,7 @@ namespace vk
     {
         enum : unsigned
         {
+            eTransferDst    = 0x00000002,
             eUniformBuffer  = 0x00000010,
             eStorageBuffer  = 0x00000020,
             eIndexBuffer    = 0x00000040,
@@ -96,6 +119,45 @@ namespace vk
         };
     }
 
+    namespace PipelineStage
+    {
+        enum : unsigned long long
+        {
+            eNone                  = 0x00000000,
+            eDrawIndirect          = 0x00000002,
+            eVertexShader          = 0x00000008,
+            eFragmentShader        = 0x00000080,
+            eColorAttachmentOutput = 0x00000400,
+            eComputeShader         = 0x00000800,
+            eTransfer              = 0x00001000,
+            eHost                  = 0x00004000,
+            eAllCommands           = 0x00010000,
+            eTaskShader            = 0x00080000,
+            eMeshShader            = 0x00100000
+        };
+    }
+
+    namespace Access
+    {
+        enum : unsigned long long
+        {
+            eNone                 = 0x00000000,
+            eIndirectCommandRead  = 0x00000001,
+            eIndexRead            = 0x00000002,
+            eUniformRead          = 0x00000008,
+            eShaderRead           = 0x00000020,
+            eShaderWrite          = 0x00000040,
+            eTransferRead         = 0x00000800,
+            eTransferWrite        = 0x00001000,
+            eHostRead             = 0x00002000,
+            eHostWrite            = 0x00004000,
+            eMemoryRead           = 0x00008000,
+            eMemoryWrite          = 0x00010000,
+            eShaderStorageRead    = 0x200000000,
+            eShaderStorageWrite   = 0x400000000
+        };
+    }
+
     namespace ShaderStage
     {
         enum : unsigned
@@ -103,7 +165,9 @@ namespace vk
             eVertex   = 0x00000001,
             eGeometry = 0x00000008,
             eFragment = 0x00000010,
-            eCompute  = 0x00000020
+            eCompute  = 0x00000020,
+            eTask     = 0x00000040,
+            eMesh     = 0x00000080
         };
     }
 }
\ No newline at end of file
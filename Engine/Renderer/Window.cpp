@@ -1,4 +1,5 @@
 #include "Window.hpp"
+#include "Profiler.hpp"
 #include <stdexcept>
 #include <chrono>
 #include <SDL3/SDL.h>
@@ -9,7 +10,7 @@ Window::Window()
     : m{
         .size = {1280, 720},
         .pos = {50, 50},
-        .title = std::pmr::string("Light Frame", &pmr::g_rsrc),
+        .title = std::pmr::string("Light Frame", &pmr::g_persistentArena),
         .available = true
     }
 {
@@ -31,6 +32,7 @@ Window::Window()
     }
     
     SDL_SetWindowPosition(m.handle, m.pos.x, m.pos.y);
+    m.title.reserve(128);
     m.keyboardState = const_cast<u8*>(SDL_GetKeyboardState(nullptr));
 
     SDL_GetWindowSize(m.handle, &m.size.x, &m.size.y);
@@ -50,6 +52,8 @@ Window::~Window()
 
 auto Window::update() -> void
 {
+    LF_PROFILE_ZONE("Window::update");
+
     auto static event       { SDL_Event{} };
     auto static previousTime{ getTime()   };
     auto        currentTime { getTime()   };
@@ -96,6 +100,12 @@ auto Window::setTitle(std::string_view title) -> void
     SDL_SetWindowTitle(m.handle, m.title.c_str());
 }
 
+auto Window::setSize(glm::ivec2 size) -> void
+{
+    SDL_SetWindowSize(m.handle, size.x, size.y);
+    SDL_GetWindowSize(m.handle, &m.size.x, &m.size.y);
+}
+
 auto Window::setCursorPos(glm::vec2 pos) -> void
 {
     SDL_WarpMouseInWindow(m.handle, pos.x, pos.y);
@@ -0,0 +1,454 @@
+#include "Bvh.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <stdexcept>
+
+// Half the surface area, which is all the cost comparisons need.
+static auto getArea(Aabb const& bounds) -> f32
+{
+    auto const x{ bounds.max[0] - bounds.min[0] };
+    auto const y{ bounds.max[1] - bounds.min[1] };
+    auto const z{ bounds.max[2] - bounds.min[2] };
+
+    return x * y + y * z + z * x;
+}
+
+static auto getUnion(Aabb const& a, Aabb const& b) -> Aabb
+{
+    return Aabb{
+        .min = { std::min(a.min[0], b.min[0]), std::min(a.min[1], b.min[1]), std::min(a.min[2], b.min[2]) },
+        .max = { std::max(a.max[0], b.max[0]), std::max(a.max[1], b.max[1]), std::max(a.max[2], b.max[2]) }
+    };
+}
+
+static constexpr auto emptyBounds{ Aabb{ .min = { FLT_MAX, FLT_MAX, FLT_MAX }, .max = { -FLT_MAX, -FLT_MAX, -FLT_MAX } } };
+
+auto Bvh::build(std::span<Aabb const> bounds) -> void
+{
+    m.bounds.assign(bounds.begin(), bounds.end());
+    m.itemSlots.assign(bounds.size(), noItem);
+    m.pendingRebuild = true;
+
+    this->refit();
+}
+
+// Items added after the last build are held in bounds until the next refit, which rebuilds.
+auto Bvh::insert(Aabb const& bounds) -> u32
+{
+    auto const item{ this->getItemCount() };
+
+    m.itemSlots.emplace_back(noItem);
+    m.bounds.resize(m.itemSlots.size());
+    m.bounds[item] = bounds;
+    m.pendingRebuild = true;
+
+    return item;
+}
+
+auto Bvh::update(u32 item, Aabb const& bounds) -> void
+{
+    if (item >= this->getItemCount())
+    {
+        throw std::runtime_error("Failed to update bvh item: index out of range");
+    }
+
+    auto const slot{ m.itemSlots[item] };
+
+    if (slot == noItem)
+    {
+        m.bounds[item] = bounds;
+        return;
+    }
+
+    auto const node{ slot / width };
+
+    m.cost += getArea(bounds) - getArea(this->getSlot(node, slot % width));
+    this->setSlot(node, slot % width, bounds);
+    m.dirty[node] = true;
+}
+
+// Parents always precede their children, so one reverse sweep grows every dirty ancestor after
+// its descendants are final.
+auto Bvh::refit() -> void
+{
+    LF_PROFILE_ZONE("Bvh::refit");
+
+    if (m.pendingRebuild || m.cost > m.builtCost * rebuildRatio)
+    {
+        for (auto item{ u32{} }, count{ this->getItemCount() }; item < count; ++item)
+        {
+            if (m.itemSlots[item] != noItem)
+            {
+                m.bounds[item] = this->getSlot(m.itemSlots[item] / width, m.itemSlots[item] % width);
+            }
+        }
+
+        m.nodes.clear();
+        m.order.resize(m.bounds.size());
+
+        for (auto i{ u32{} }; i < m.order.size(); ++i)
+        {
+            m.order[i] = i;
+        }
+
+        if (!m.order.empty())
+        {
+            this->buildNode(0, static_cast<u32>(m.order.size()), noItem);
+        }
+
+        m.dirty.assign(m.nodes.size(), false);
+        m.cost = 0.f;
+
+        for (auto const& node : m.nodes)
+        {
+            for (auto slot{ u32{} }; slot < node.childCount; ++slot)
+            {
+                m.cost += getArea(Aabb{
+                    .min = { node.minX[slot], node.minY[slot], node.minZ[slot] },
+                    .max = { node.maxX[slot], node.maxY[slot], node.maxZ[slot] }
+                });
+            }
+        }
+
+        m.builtCost = m.cost;
+        m.pendingRebuild = false;
+        ++m.rebuildCount;
+
+        return;
+    }
+
+    for (auto node{ this->getNodeCount() }; node-- > 0;)
+    {
+        if (!m.dirty[node])
+        {
+            continue;
+        }
+
+        m.dirty[node] = false;
+
+        auto const parent{ m.nodes[node].parent };
+
+        if (parent == noItem)
+        {
+            continue;
+        }
+
+        auto bounds{ emptyBounds };
+
+        for (auto slot{ u32{} }; slot < m.nodes[node].childCount; ++slot)
+        {
+            bounds = getUnion(bounds, this->getSlot(node, slot));
+        }
+
+        m.cost += getArea(bounds) - getArea(this->getSlot(parent / width, parent % width));
+        this->setSlot(parent / width, parent % width, bounds);
+        m.dirty[parent / width] = true;
+    }
+}
+
+// Splits the range into up to four groups by median splits of the largest group on its widest
+// centroid axis. Groups of one item go straight into a slot; larger groups become child nodes.
+auto Bvh::buildNode(u32 first, u32 count, u32 parent) -> u32
+{
+    auto const node{ this->getNodeCount() };
+
+    m.nodes.emplace_back(Node{ .parent = parent });
+
+    auto ranges{ std::array<std::array<u32, 2>, width>{} };
+    auto rangeCount{ 0u };
+
+    if (count <= width)
+    {
+        for (; rangeCount < count; ++rangeCount)
+        {
+            ranges[rangeCount] = { first + rangeCount, 1 };
+        }
+    }
+    else
+    {
+        ranges[rangeCount++] = { first, count };
+
+        while (rangeCount < width)
+        {
+            auto largest{ 0u };
+
+            for (auto range{ 1u }; range < rangeCount; ++range)
+            {
+                largest = ranges[range][1] > ranges[largest][1] ? range : largest;
+            }
+
+            auto const [begin, size]{ ranges[largest] };
+            auto const half{ this->splitRange(begin, size) };
+
+            ranges[largest] = { begin, half };
+            ranges[rangeCount++] = { begin + half, size - half };
+        }
+    }
+
+    m.nodes[node].childCount = rangeCount;
+
+    for (auto slot{ rangeCount }; slot < width; ++slot)
+    {
+        this->setSlot(node, slot, emptyBounds);
+        m.nodes[node].children[slot] = noItem;
+    }
+
+    for (auto slot{ u32{} }; slot < rangeCount; ++slot)
+    {
+        auto const [begin, size]{ ranges[slot] };
+
+        if (size == 1)
+        {
+            auto const item{ m.order[begin] };
+
+            this->setSlot(node, slot, m.bounds[item]);
+            m.nodes[node].children[slot] = item | leafBit;
+            m.itemSlots[item] = node * width + slot;
+
+            continue;
+        }
+
+        auto const child{ this->buildNode(begin, size, node * width + slot) };
+        auto bounds{ emptyBounds };
+
+        for (auto childSlot{ u32{} }; childSlot < m.nodes[child].childCount; ++childSlot)
+        {
+            bounds = getUnion(bounds, this->getSlot(child, childSlot));
+        }
+
+        this->setSlot(node, slot, bounds);
+        m.nodes[node].children[slot] = child;
+    }
+
+    return node;
+}
+
+// Partitions the range around the median centroid on its widest centroid axis and returns the
+// size of the lower half. Centroids are kept doubled, which leaves the ordering unchanged.
+auto Bvh::splitRange(u32 begin, u32 size) -> u32
+{
+    auto centroidBounds{ emptyBounds };
+
+    for (auto i{ begin }; i < begin + size; ++i)
+    {
+        auto const& bounds{ m.bounds[m.order[i]] };
+
+        for (auto axis{ 0u }; axis < 3; ++axis)
+        {
+            auto const centroid{ bounds.min[axis] + bounds.max[axis] };
+
+            centroidBounds.min[axis] = std::min(centroidBounds.min[axis], centroid);
+            centroidBounds.max[axis] = std::max(centroidBounds.max[axis], centroid);
+        }
+    }
+
+    auto axis{ 0u };
+
+    for (auto candidate{ 1u }; candidate < 3; ++candidate)
+    {
+        if (centroidBounds.max[candidate] - centroidBounds.min[candidate] > centroidBounds.max[axis] - centroidBounds.min[axis])
+        {
+            axis = candidate;
+        }
+    }
+
+    auto const half{ size / 2 };
+    auto* const order{ m.order.data() };
+
+    std::nth_element(order + begin, order + begin + half, order + begin + size, [&](u32 a, u32 b){
+        return m.bounds[a].min[axis] + m.bounds[a].max[axis] < m.bounds[b].min[axis] + m.bounds[b].max[axis];
+    });
+
+    return half;
+}
+
+auto Bvh::setSlot(u32 node, u32 slot, Aabb const& bounds) -> void
+{
+    auto& target{ m.nodes[node] };
+
+    target.minX[slot] = bounds.min[0];
+    target.minY[slot] = bounds.min[1];
+    target.minZ[slot] = bounds.min[2];
+    target.maxX[slot] = bounds.max[0];
+    target.maxY[slot] = bounds.max[1];
+    target.maxZ[slot] = bounds.max[2];
+}
+
+auto Bvh::getSlot(u32 node, u32 slot) const -> Aabb
+{
+    auto const& source{ m.nodes[node] };
+
+    return Aabb{
+        .min = { source.minX[slot], source.minY[slot], source.minZ[slot] },
+        .max = { source.maxX[slot], source.maxY[slot], source.maxZ[slot] }
+    };
+}
+
+auto Bvh::collect(u32 child, std::vector<u32>& items) const -> void
+{
+    if (child & leafBit)
+    {
+        items.emplace_back(child & ~leafBit);
+        return;
+    }
+
+    for (auto slot{ u32{} }; slot < m.nodes[child].childCount; ++slot)
+    {
+        this->collect(m.nodes[child].children[slot], items);
+    }
+}
+
+// Appends every item whose box is not fully outside one of the planes. Children entirely inside
+// all planes are collected without further tests. Items inserted since the last refit are missed.
+auto Bvh::queryFrustum(Frustum const& frustum, std::vector<u32>& items) const -> void
+{
+    LF_PROFILE_ZONE("Bvh::queryFrustum");
+
+    if (m.nodes.empty())
+    {
+        return;
+    }
+
+    auto stack{ std::array<u32, 128>{} };
+    auto stackSize{ 1u };
+
+    stack[0] = 0;
+
+    while (stackSize)
+    {
+        auto const& node{ m.nodes[stack[--stackSize]] };
+
+        auto outside{ std::array<u32, width>{} };
+        auto inside { std::array<u32, width>{ 1, 1, 1, 1 } };
+
+        for (auto const& plane : frustum.planes)
+        {
+            auto const [a, b, c, d]{ plane };
+
+            for (auto lane{ 0u }; lane < width; ++lane)
+            {
+                auto const nearest{
+                    a * (a > 0.f ? node.maxX[lane] : node.minX[lane]) +
+                    b * (b > 0.f ? node.maxY[lane] : node.minY[lane]) +
+                    c * (c > 0.f ? node.maxZ[lane] : node.minZ[lane]) + d
+                };
+
+                auto const farthest{
+                    a * (a > 0.f ? node.minX[lane] : node.maxX[lane]) +
+                    b * (b > 0.f ? node.minY[lane] : node.maxY[lane]) +
+                    c * (c > 0.f ? node.minZ[lane] : node.maxZ[lane]) + d
+                };
+
+                outside[lane] |= nearest < 0.f;
+                inside[lane] &= farthest >= 0.f;
+            }
+        }
+
+        for (auto lane{ 0u }; lane < node.childCount; ++lane)
+        {
+            auto const child{ node.children[lane] };
+
+            if (outside[lane])
+            {
+                continue;
+            }
+
+            if ((child & leafBit) || inside[lane])
+            {
+                this->collect(child, items);
+            }
+            else
+            {
+                stack[stackSize++] = child;
+            }
+        }
+    }
+}
+
+// Nearest item box hit by the ray within maxDistance, or noItem. Hit children are visited nearest
+// first, and subtrees starting beyond the current hit are skipped.
+auto Bvh::raycast(f32 const origin[3], f32 const direction[3], f32 maxDistance) const -> RayHit
+{
+    auto hit{ RayHit{ .item = noItem, .distance = maxDistance } };
+
+    if (m.nodes.empty())
+    {
+        return hit;
+    }
+
+    auto inverse{ std::array<f32, 3>{} };
+
+    for (auto axis{ 0u }; axis < 3; ++axis)
+    {
+        inverse[axis] = 1.f / (direction[axis] != 0.f ? direction[axis] : 1e-30f);
+    }
+
+    struct Entry
+    {
+        u32 node;
+        f32 distance;
+    };
+
+    auto stack{ std::array<Entry, 128>{} };
+    auto stackSize{ 1u };
+
+    stack[0] = { 0, 0.f };
+
+    while (stackSize)
+    {
+        auto const entry{ stack[--stackSize] };
+
+        if (entry.distance > hit.distance)
+        {
+            continue;
+        }
+
+        auto const& node{ m.nodes[entry.node] };
+
+        auto nearDistance{ std::array<f32, width>{} };
+        auto farDistance { std::array<f32, width>{} };
+
+        for (auto lane{ 0u }; lane < width; ++lane)
+        {
+            auto const x0{ (node.minX[lane] - origin[0]) * inverse[0] }, x1{ (node.maxX[lane] - origin[0]) * inverse[0] };
+            auto const y0{ (node.minY[lane] - origin[1]) * inverse[1] }, y1{ (node.maxY[lane] - origin[1]) * inverse[1] };
+            auto const z0{ (node.minZ[lane] - origin[2]) * inverse[2] }, z1{ (node.maxZ[lane] - origin[2]) * inverse[2] };
+
+            nearDistance[lane] = std::max({ std::min(x0, x1), std::min(y0, y1), std::min(z0, z1), 0.f });
+            farDistance[lane] = std::min({ std::max(x0, x1), std::max(y0, y1), std::max(z0, z1) });
+        }
+
+        auto hitLanes{ std::array<u32, width>{} };
+        auto hitCount{ 0u };
+
+        for (auto lane{ 0u }; lane < node.childCount; ++lane)
+        {
+            if (nearDistance[lane] > farDistance[lane] || nearDistance[lane] > hit.distance)
+            {
+                continue;
+            }
+
+            if (node.children[lane] & leafBit)
+            {
+                hit = RayHit{ .item = node.children[lane] & ~leafBit, .distance = nearDistance[lane] };
+                continue;
+            }
+
+            hitLanes[hitCount++] = lane;
+        }
+
+        // Pushed farthest first so the nearest child is popped next.
+        std::sort(hitLanes.begin(), hitLanes.begin() + hitCount, [&](u32 a, u32 b){
+            return nearDistance[a] > nearDistance[b];
+        });
+
+        for (auto i{ u32{} }; i < hitCount; ++i)
+        {
+            stack[stackSize++] = { node.children[hitLanes[i]], nearDistance[hitLanes[i]] };
+        }
+    }
+
+    return hit;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "Types.hpp"
+#include <span>
+#include <vector>
+
+struct Aabb
+{
+    f32 min[3];
+    f32 max[3];
+};
+
+// Planes with normals pointing inwards, as (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside.
+struct Frustum
+{
+    f32 planes[6][4];
+};
+
+struct RayHit
+{
+    u32 item;
+    f32 distance;
+};
+
+// Four-wide bounding volume hierarchy over item boxes. Each node keeps the bounds of its children
+// as a structure of arrays, so one node visit tests four boxes with straight-line loops. A child
+// is either another node or, with the leaf bit set, an item, whose box lives directly in its
+// parent's slot.
+//
+// Moving items only refits: update rewrites the item's slot and refit grows the ancestors. Once
+// the summed child area has degraded past rebuildRatio times its value after the last build, refit
+// rebuilds from the current item boxes instead.
+class Bvh
+{
+public:
+    static constexpr auto width       { 4u };
+    static constexpr auto leafBit     { 1u << 31 };
+    static constexpr auto noItem      { ~0u };
+    static constexpr auto rebuildRatio{ 2.f };
+
+public:
+    auto build(std::span<Aabb const> bounds) -> void;
+    auto insert(Aabb const& bounds) -> u32;
+    auto update(u32 item, Aabb const& bounds) -> void;
+    auto refit() -> void;
+    auto queryFrustum(Frustum const& frustum, std::vector<u32>& items) const -> void;
+    auto raycast(f32 const origin[3], f32 const direction[3], f32 maxDistance) const -> RayHit;
+
+public:
+    inline auto getItemCount() const noexcept -> u32
+    {
+        return static_cast<u32>(m.itemSlots.size());
+    }
+
+    inline auto getNodeCount() const noexcept -> u32
+    {
+        return static_cast<u32>(m.nodes.size());
+    }
+
+    inline auto getRebuildCount() const noexcept -> u32
+    {
+        return m.rebuildCount;
+    }
+
+private:
+    // Two cache lines: six bound arrays, the children, and the parent slot for refitting.
+    struct alignas(64) Node
+    {
+        f32 minX[width];
+        f32 minY[width];
+        f32 minZ[width];
+        f32 maxX[width];
+        f32 maxY[width];
+        f32 maxZ[width];
+        u32 children[width];
+        u32 parent;
+        u32 childCount;
+        u32 padding[2];
+    };
+
+    static_assert(sizeof(Node) == 128);
+
+private:
+    auto buildNode(u32 first, u32 count, u32 parent) -> u32;
+    auto splitRange(u32 begin, u32 size) -> u32;
+    auto setSlot(u32 node, u32 slot, Aabb const& bounds) -> void;
+    auto getSlot(u32 node, u32 slot) const -> Aabb;
+    auto collect(u32 child, std::vector<u32>& items) const -> void;
+
+private:
+    struct M
+    {
+        std::vector<Node> nodes;
+        std::vector<u8>   dirty;
+        std::vector<u32>  itemSlots;
+        std::vector<u32>  order;
+        std::vector<Aabb> bounds;
+        f32               cost{};
+        f32               builtCost{};
+        u32               rebuildCount{};
+        bool              pendingRebuild{};
+    } m;
+};
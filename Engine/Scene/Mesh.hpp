@@ -1,10 +1,68 @@
 #pragma once
 #include "Types.hpp"
 
-struct Mesh
+// One level of detail: an index range over the mesh's vertices and the object-space distance
+// by which the simplified surface may deviate from the full-resolution one.
+struct MeshLod
 {
+    u32 indexOffset;
     u32 indexCount;
-    u32 vertexCount;
+    f32 error;
+};
+
+// Bounds of a mesh in its own space: an axis-aligned box given by its center and half extent,
+// and a sphere around the same center. Matches the MeshBounds struct in the culling shaders.
+struct MeshBounds
+{
+    f32 center[3];
+    f32 radius;
+    f32 extent[3];
+    f32 padding;
+};
+
+// Index offsets count in units of the mesh's own index size, so they can be used as firstIndex
+// with the shared index buffer bound as 16 or 32 bit. indexOffset and indexCount describe LOD 0.
+struct Mesh
+{
+    static constexpr auto maxLods{ 4u };
+
+    u32        indexCount;
+    u32        vertexCount;
+    u32        vertexOffset;
+    u32        indexOffset;
+    u32        indexSize;
+    u32        meshletOffset;
+    u32        meshletCount;
+    MeshBounds bounds;
+    u32        lodCount;
+    MeshLod    lods[maxLods];
+};
+
+// Matches the Meshlet struct in the meshlet shaders. Vertex indices are global, triangles are
+// byte triplets indexing the meshlet's vertices. The cone is the s8 normal cone from meshopt.
+struct Meshlet
+{
+    f32 center[3];
+    f32 radius;
+    i8  coneAxis[3];
+    i8  coneCutoff;
     u32 vertexOffset;
-    u32 indexOffset;
-};
\ No newline at end of file
+    u32 triangleOffset;
+    u8  vertexCount;
+    u8  triangleCount;
+    u16 mesh;
+};
+
+// Matches the MeshParams struct in the shaders. Quantized positions decode as
+// positionOffset + positionScale * q; normals are octahedral snorm pairs of normalBits each.
+struct MeshParams
+{
+    f32 positionOffset[3];
+    u32 vertexOffset;
+    f32 positionScale[3];
+    u32 normalBits;
+};
+
+static_assert(sizeof(MeshBounds) == 32);
+static_assert(sizeof(Meshlet) == 32);
+static_assert(sizeof(MeshParams) == 32);
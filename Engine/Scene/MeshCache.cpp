@@ -0,0 +1,245 @@
+#include "MeshCache.hpp"
+#include "MeshLoader.hpp"
+#include "MappedFile.hpp"
+#include "Profiler.hpp"
+#include <spdlog/spdlog.h>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <span>
+#include <string>
+
+namespace cache
+{
+    struct Header
+    {
+        u32       magic;
+        u32       version;
+        u64       key;
+        u32       meshCount;
+        u32       vertexCount;
+        u32       indexWordCount;
+        u32       meshletCount;
+        u32       meshletVertexCount;
+        u32       meshletTriangleCount;
+        MeshBases bases;
+    };
+
+    enum Section : u32
+    {
+        eMeshes,
+        eParams,
+        ePositions,
+        eUvs,
+        eNormals,
+        eIndices,
+        eMeshlets,
+        eMeshletVertices,
+        eMeshletTriangles,
+        eSectionCount
+    };
+
+    // Sections start on 16-byte boundaries so the mapped streams are aligned for any element type.
+    static auto align(size_t size) -> size_t
+    {
+        return (size + 15) & ~size_t{ 15 };
+    }
+
+    static auto getSectionSizes(Header const& header) -> std::array<size_t, eSectionCount>
+    {
+        return {
+            header.meshCount * sizeof(Mesh),
+            header.meshCount * sizeof(MeshParams),
+            header.vertexCount * 3 * sizeof(u16),
+            header.vertexCount * 2 * sizeof(u16),
+            header.vertexCount * sizeof(u32),
+            header.indexWordCount * sizeof(u32),
+            header.meshletCount * sizeof(Meshlet),
+            header.meshletVertexCount * sizeof(u32),
+            header.meshletTriangleCount * sizeof(u8)
+        };
+    }
+
+    template<typename T>
+    static auto append(std::vector<T>& target, u8 const* data, size_t size) -> void
+    {
+        auto const offset{ target.size() };
+
+        target.resize(offset + size / sizeof(T));
+        std::memcpy(target.data() + offset, data, size);
+    }
+}
+
+auto cache::getBases(MeshLoader const& loader) -> MeshBases
+{
+    return {
+        .vertex = static_cast<u32>(loader.uvs.size() >> 1),
+        .indexWord = static_cast<u32>(loader.indices.size()),
+        .mesh = static_cast<u32>(loader.params.size()),
+        .meshlet = static_cast<u32>(loader.meshlets.size()),
+        .meshletVertex = static_cast<u32>(loader.meshletVertices.size()),
+        .meshletTriangle = static_cast<u32>(loader.meshletTriangles.size())
+    };
+}
+
+// 64-bit FNV-1a over the source bytes followed by the option word.
+auto cache::makeKey(u8 const* source, size_t size, u64 options) -> u64
+{
+    auto hash{ u64{ 0xCBF29CE484222325 } };
+
+    for (auto const byte : std::span{ source, size })
+    {
+        hash = (hash ^ byte) * 0x100000001B3;
+    }
+
+    for (auto i{ 0u }; i < sizeof(options); ++i)
+    {
+        hash = (hash ^ (options >> i * 8 & 0xFF)) * 0x100000001B3;
+    }
+
+    return hash;
+}
+
+auto cache::readMeshes(std::string_view path, u64 key, MeshLoader& loader, std::vector<Mesh>& meshes) -> bool
+{
+    LF_PROFILE_ZONE("cache::readMeshes");
+
+    auto const file{ MappedFile{ path } };
+
+    if (!file || file.getSize() < sizeof(Header))
+    {
+        return false;
+    }
+
+    auto header{ Header{} };
+    std::memcpy(&header, file.getData(), sizeof(Header));
+
+    if (header.magic != magic || header.version != version || header.key != key)
+    {
+        return false;
+    }
+
+    auto const sizes{ getSectionSizes(header) };
+    auto const expectedSize{ std::accumulate(sizes.begin(), sizes.end(), align(sizeof(Header)), [](size_t total, size_t size){
+        return total + align(size);
+    })};
+
+    if (file.getSize() != expectedSize)
+    {
+        spdlog::warn("Ignored truncated mesh cache [ path: {} ]", path);
+        return false;
+    }
+
+    auto sections{ std::array<u8 const*, eSectionCount>{} };
+    auto cursor{ file.getData() + align(sizeof(Header)) };
+
+    for (auto i{ 0u }; i < eSectionCount; ++i)
+    {
+        sections[i] = cursor;
+        cursor += align(sizes[i]);
+    }
+
+    // The cache stores offsets as they were at write time; shift them onto the loader's current end.
+    auto const current{ getBases(loader) };
+    auto const delta{ MeshBases{
+        .vertex = current.vertex - header.bases.vertex,
+        .indexWord = current.indexWord - header.bases.indexWord,
+        .mesh = current.mesh - header.bases.mesh,
+        .meshlet = current.meshlet - header.bases.meshlet,
+        .meshletVertex = current.meshletVertex - header.bases.meshletVertex,
+        .meshletTriangle = current.meshletTriangle - header.bases.meshletTriangle
+    }};
+
+    meshes.resize(header.meshCount);
+    std::memcpy(meshes.data(), sections[eMeshes], sizes[eMeshes]);
+
+    append(loader.params, sections[eParams], sizes[eParams]);
+    append(loader.positions, sections[ePositions], sizes[ePositions]);
+    append(loader.uvs, sections[eUvs], sizes[eUvs]);
+    append(loader.normals, sections[eNormals], sizes[eNormals]);
+    append(loader.indices, sections[eIndices], sizes[eIndices]);
+    append(loader.meshlets, sections[eMeshlets], sizes[eMeshlets]);
+    append(loader.meshletVertices, sections[eMeshletVertices], sizes[eMeshletVertices]);
+    append(loader.meshletTriangles, sections[eMeshletTriangles], sizes[eMeshletTriangles]);
+
+    loader.rebase(delta, meshes, current);
+
+    spdlog::info(
+        "Loaded mesh cache [ path: {}; meshes: {}; vertices: {}; meshlets: {}; bytes: {} ]",
+        path,
+        header.meshCount,
+        header.vertexCount,
+        header.meshletCount,
+        file.getSize()
+    );
+
+    return true;
+}
+
+// Written to a temporary file first so an interrupted write never leaves a valid-looking cache.
+auto cache::writeMeshes(std::string_view path, u64 key, MeshLoader const& loader, MeshBases const& bases, std::vector<Mesh> const& meshes) -> void
+{
+    LF_PROFILE_ZONE("cache::writeMeshes");
+
+    auto const current{ getBases(loader) };
+
+    auto const header{ Header{
+        .magic = magic,
+        .version = version,
+        .key = key,
+        .meshCount = static_cast<u32>(meshes.size()),
+        .vertexCount = current.vertex - bases.vertex,
+        .indexWordCount = current.indexWord - bases.indexWord,
+        .meshletCount = current.meshlet - bases.meshlet,
+        .meshletVertexCount = current.meshletVertex - bases.meshletVertex,
+        .meshletTriangleCount = current.meshletTriangle - bases.meshletTriangle,
+        .bases = bases
+    }};
+
+    auto const sizes{ getSectionSizes(header) };
+    auto const temporaryPath{ std::string{ path } + ".tmp" };
+
+    {
+        auto file{ std::ofstream{ temporaryPath, std::ios::binary | std::ios::trunc } };
+
+        if (!file)
+        {
+            spdlog::warn("Failed to write mesh cache [ path: {} ]", path);
+            return;
+        }
+
+        auto const padding{ std::array<char, 16>{} };
+
+        auto const write{ [&](void const* data, size_t size){
+            file.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+            file.write(padding.data(), static_cast<std::streamsize>(align(size) - size));
+        }};
+
+        write(&header, sizeof(Header));
+        write(meshes.data(), sizes[eMeshes]);
+        write(loader.params.data() + bases.mesh, sizes[eParams]);
+        write(loader.positions.data() + bases.vertex * 3, sizes[ePositions]);
+        write(loader.uvs.data() + bases.vertex * 2, sizes[eUvs]);
+        write(loader.normals.data() + bases.vertex, sizes[eNormals]);
+        write(loader.indices.data() + bases.indexWord, sizes[eIndices]);
+        write(loader.meshlets.data() + bases.meshlet, sizes[eMeshlets]);
+        write(loader.meshletVertices.data() + bases.meshletVertex, sizes[eMeshletVertices]);
+        write(loader.meshletTriangles.data() + bases.meshletTriangle, sizes[eMeshletTriangles]);
+
+        if (!file)
+        {
+            spdlog::warn("Failed to write mesh cache [ path: {} ]", path);
+            return;
+        }
+    }
+
+    auto error{ std::error_code{} };
+    std::filesystem::rename(temporaryPath, std::string{ path }, error);
+
+    if (error)
+    {
+        spdlog::warn("Failed to write mesh cache [ path: {}; error: {} ]", path, error.message());
+    }
+}
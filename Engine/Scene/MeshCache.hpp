@@ -0,0 +1,33 @@
+#pragma once
+#include "Mesh.hpp"
+#include <string_view>
+#include <vector>
+
+class MeshLoader;
+
+// Cooked meshes: the loader's final streams, meshlets and mesh table in one file, mapped and
+// copied straight into the loader on a hit. Bump version whenever the import pipeline changes
+// its output; the key covers the source bytes and the import options.
+namespace cache
+{
+    inline constexpr auto magic    { u32{ 0x434D464C } };
+    inline constexpr auto version  { u32{ 3 } };
+    inline constexpr auto extension{ ".lfcache" };
+
+    // Sizes of the loader's shared arrays before an import. Cached ranges are stored together
+    // with the bases they were built at and are rebased when appended somewhere else.
+    struct MeshBases
+    {
+        u32 vertex;
+        u32 indexWord;
+        u32 mesh;
+        u32 meshlet;
+        u32 meshletVertex;
+        u32 meshletTriangle;
+    };
+
+    auto getBases(MeshLoader const& loader) -> MeshBases;
+    auto makeKey(u8 const* source, size_t size, u64 options) -> u64;
+    auto readMeshes(std::string_view path, u64 key, MeshLoader& loader, std::vector<Mesh>& meshes) -> bool;
+    auto writeMeshes(std::string_view path, u64 key, MeshLoader const& loader, MeshBases const& bases, std::vector<Mesh> const& meshes) -> void;
+}
@@ -1,63 +1,235 @@
 #include "MeshLoader.hpp" 
+#include "MeshCache.hpp"
+#include "MappedFile.hpp"
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <meshoptimizer.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <span>
 #include <stdexcept>
+#include <string>
+
+MeshLoader::MeshLoader()
+    : MeshLoader{ nullptr }
+{}
+
+MeshLoader::MeshLoader(JobSystem* jobs)
+    : MeshLoader{ Quantization{ .positionBits = 16, .normalBits = 16 }, jobs }
+{}
+
+MeshLoader::MeshLoader(Quantization const& quantization, JobSystem* jobs)
+    : m{ .quantization = quantization, .jobs = jobs }
+{
+    if (quantization.positionBits < 1 || quantization.positionBits > 16 || quantization.normalBits < 2 || quantization.normalBits > 16)
+    {
+        throw std::runtime_error("Failed to create MeshLoader: quantization bits out of range");
+    }
+}
 
 auto MeshLoader::loadMesh(std::string_view path, bool flipUV) -> std::vector<Mesh>
 {
+    LF_PROFILE_ZONE("MeshLoader::loadMesh");
+
     m.result.clear();
 
+    auto const cachePath{ std::string{ path } + cache::extension };
+    auto const source   { m.cacheEnabled ? MappedFile{ path } : MappedFile{} };
+    auto const key      { source ? cache::makeKey(source.getData(), source.getSize(), getCacheOptions(flipUV)) : u64{} };
+
+    if (source && cache::readMeshes(cachePath, key, *this, m.result))
+    {
+        return m.result;
+    }
+
+    auto const bases{ cache::getBases(*this) };
+
     auto importer{ Assimp::Importer{} };
     auto const* scene{ importer.ReadFile(path.data(), aiProcess_Triangulate | aiProcess_GenNormals | (flipUV ? aiProcess_FlipUVs : 0)) };
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
     {
-        std::runtime_error(importer.GetErrorString());
+        throw std::runtime_error(importer.GetErrorString());
     }
 
-    processNode(scene->mRootNode, scene);
+    importScene(scene);
+
+    if (source)
+    {
+        cache::writeMeshes(cachePath, key, *this, bases, m.result);
+    }
 
     return m.result;
 }
 
-auto MeshLoader::processNode(aiNode* pNode, aiScene const* pScene) -> void
+auto MeshLoader::rebase(cache::MeshBases const& bases, std::vector<Mesh>& meshes, cache::MeshBases const& first) -> void
+{
+    for (auto& mesh : meshes)
+    {
+        auto const indexOffset{ mesh.indexSize == sizeof(u16) ? bases.indexWord * 2 : bases.indexWord };
+
+        mesh.vertexOffset += bases.vertex;
+        mesh.indexOffset += indexOffset;
+        mesh.meshletOffset += bases.meshlet;
+
+        for (auto& lod : std::span{ mesh.lods, mesh.lodCount })
+        {
+            lod.indexOffset += indexOffset;
+        }
+    }
+
+    for (auto& meshParams : std::span{ params }.subspan(first.mesh))
+    {
+        meshParams.vertexOffset += bases.vertex;
+    }
+
+    for (auto& meshlet : std::span{ meshlets }.subspan(first.meshlet))
+    {
+        meshlet.vertexOffset += bases.meshletVertex;
+        meshlet.triangleOffset += bases.meshletTriangle;
+        meshlet.mesh = static_cast<u16>(meshlet.mesh + bases.mesh);
+    }
+
+    for (auto& vertex : std::span{ meshletVertices }.subspan(first.meshletVertex))
+    {
+        vertex += bases.vertex;
+    }
+}
+
+// Everything besides the source bytes that changes the cooked output.
+auto MeshLoader::getCacheOptions(bool flipUV) const -> u64
+{
+    return u64{ flipUV }
+        | u64{ m.quantization.positionBits } << 8
+        | u64{ m.quantization.normalBits } << 16
+        | u64{ maxMeshletVertices } << 24
+        | u64{ maxMeshletTriangles } << 32;
+}
+
+// Two phases: every mesh is converted on its own, in parallel, then the converted sizes are
+// prefix-summed so the shared arrays grow once and each mesh is copied into its own range.
+// The output depends only on the node order, never on scheduling.
+auto MeshLoader::importScene(aiScene const* pScene) -> void
+{
+    LF_PROFILE_ZONE("MeshLoader::importScene");
+
+    auto sceneMeshes{ std::vector<aiMesh*>{} };
+    collectMeshes(pScene->mRootNode, pScene, sceneMeshes);
+
+    auto const meshCount{ static_cast<u32>(sceneMeshes.size()) };
+
+    auto const forEachMesh{ [this, meshCount](auto const& function){
+        if (!m.jobs)
+        {
+            for (auto i{ u32{} }; i < meshCount; ++i)
+            {
+                function(i);
+            }
+
+            return;
+        }
+
+        auto counter{ JobSystem::Counter{} };
+
+        m.jobs->parallelFor(counter, meshCount, 1, [&function](u32 begin, u32 end){
+            for (auto i{ begin }; i < end; ++i)
+            {
+                function(i);
+            }
+        });
+
+        m.jobs->wait(counter);
+    }};
+
+    auto data{ std::vector<MeshData>(meshCount) };
+
+    forEachMesh([&](u32 i){
+        processMesh(sceneMeshes[i], data[i]);
+    });
+
+    auto const firstParams{ params.size() };
+    auto meshBases{ std::vector<MeshBase>(meshCount) };
+
+    auto next{ MeshBase{
+        .vertex = uvs.size() >> 1,
+        .indexWord = indices.size(),
+        .meshlet = meshlets.size(),
+        .meshletVertex = meshletVertices.size(),
+        .meshletTriangle = meshletTriangles.size()
+    }};
+
+    for (auto i{ u32{} }; i < meshCount; ++i)
+    {
+        meshBases[i] = next;
+
+        next.vertex += data[i].mesh.vertexCount;
+        next.indexWord += getIndexWordCount(data[i]);
+        next.meshlet += data[i].meshlets.size();
+        next.meshletVertex += data[i].meshletVertices.size();
+        next.meshletTriangle += data[i].meshletTriangles.size();
+    }
+
+    positions.resize(next.vertex * 3);
+    uvs.resize(next.vertex * 2);
+    normals.resize(next.vertex);
+    indices.resize(next.indexWord);
+    params.resize(firstParams + meshCount);
+    meshlets.resize(next.meshlet);
+    meshletVertices.resize(next.meshletVertex);
+    meshletTriangles.resize(next.meshletTriangle);
+    m.result.resize(meshCount);
+
+    forEachMesh([&](u32 i){
+        m.result[i] = placeMesh(data[i], meshBases[i], static_cast<u32>(firstParams + i));
+    });
+
+    spdlog::info("Imported scene [ meshes: {}; vertices: {}; meshlets: {} ]", meshCount, next.vertex, next.meshlet);
+}
+
+auto MeshLoader::collectMeshes(aiNode* pNode, aiScene const* pScene, std::vector<aiMesh*>& meshes) -> void
 {
     for (auto i{ u32{} }; i < pNode->mNumMeshes; ++i)
     {
-        aiMesh *mesh = pScene->mMeshes[pNode->mMeshes[i]]; 
-        m.result.push_back(processMesh(mesh, pScene));			
+        meshes.emplace_back(pScene->mMeshes[pNode->mMeshes[i]]);
     }
-    
+
     for (auto i{ u32{} }; i < pNode->mNumChildren; ++i)
     {
-        processNode(pNode->mChildren[i], pScene);
+        collectMeshes(pNode->mChildren[i], pScene, meshes);
     }
 }
 
-auto MeshLoader::processMesh(aiMesh* pMesh, aiScene const* pScene) -> Mesh
+auto MeshLoader::processMesh(aiMesh* pMesh, MeshData& data) -> void
 {
-    auto result{ Mesh{
-        .vertexOffset = static_cast<u32>(uvs.size() >> 1),
-        .indexOffset = static_cast<u32>(indices.size())
-    }};
+    LF_PROFILE_ZONE("MeshLoader::processMesh");
+
+    auto meshPositions{ std::vector<f32>{} };
+    auto meshNormals  { std::vector<f32>{} };
+    auto meshUvs      { std::vector<f32>{} };
+    auto meshIndices  { std::vector<u32>{} };
 
-    positions.reserve(pMesh->mNumVertices * 3);
-    normals.reserve(pMesh->mNumVertices * 3);
-    uvs.reserve(pMesh->mNumVertices * 2);
+    meshPositions.reserve(pMesh->mNumVertices * 3);
+    meshNormals.reserve(pMesh->mNumVertices * 3);
+    meshUvs.reserve(pMesh->mNumVertices * 2);
+    meshIndices.reserve(pMesh->mNumFaces * 3);
 
     for (u32 i = 0; i < pMesh->mNumVertices; ++i)
     {
-        positions.emplace_back(pMesh->mVertices[i].x);
-        positions.emplace_back(pMesh->mVertices[i].y);
-        positions.emplace_back(pMesh->mVertices[i].z);
+        meshPositions.emplace_back(pMesh->mVertices[i].x);
+        meshPositions.emplace_back(pMesh->mVertices[i].y);
+        meshPositions.emplace_back(pMesh->mVertices[i].z);
 
-        normals.emplace_back(static_cast<u8>(pMesh->mNormals[i].x * 127.f + 127.5f));
-        normals.emplace_back(static_cast<u8>(pMesh->mNormals[i].y * 127.f + 127.5f));
-        normals.emplace_back(static_cast<u8>(pMesh->mNormals[i].z * 127.f + 127.5f));
+        meshNormals.emplace_back(pMesh->mNormals[i].x);
+        meshNormals.emplace_back(pMesh->mNormals[i].y);
+        meshNormals.emplace_back(pMesh->mNormals[i].z);
 
-        uvs.emplace_back(pMesh->mTextureCoords[0] ? pMesh->mTextureCoords[0][i].x : 0.f);
-        uvs.emplace_back(pMesh->mTextureCoords[0] ? pMesh->mTextureCoords[0][i].y : 0.f);
+        meshUvs.emplace_back(pMesh->mTextureCoords[0] ? pMesh->mTextureCoords[0][i].x : 0.f);
+        meshUvs.emplace_back(pMesh->mTextureCoords[0] ? pMesh->mTextureCoords[0][i].y : 0.f);
     }
 
     for (u32 i = 0; i < pMesh->mNumFaces; ++i)
@@ -66,12 +238,469 @@ auto MeshLoader::processMesh(aiMesh* pMesh, aiScene const* pScene) -> Mesh
 
         for (auto j{ u32{} }; j < face.mNumIndices; ++j)
         {
-            indices.emplace_back(face.mIndices[j]);
+            meshIndices.emplace_back(face.mIndices[j]);
+        }
+    }
+
+    optimizeMesh(pMesh->mName.C_Str(), meshPositions, meshNormals, meshUvs, meshIndices);
+
+    data.mesh.vertexCount = static_cast<u32>(meshUvs.size() >> 1);
+    data.mesh.indexCount = static_cast<u32>(meshIndices.size());
+    data.mesh.indexSize = data.mesh.vertexCount > 0x10000 ? sizeof(u32) : sizeof(u16);
+
+    buildMeshlets(data, meshPositions, meshIndices);
+    quantizeMesh(data, meshPositions, meshNormals, meshUvs);
+    buildLods(data, meshPositions, meshIndices);
+}
+
+// Copies a converted mesh into its reserved ranges and rebases every local offset. Each call
+// writes disjoint ranges, so meshes can be placed concurrently.
+auto MeshLoader::placeMesh(MeshData const& data, MeshBase const& base, u32 meshIndex) -> Mesh
+{
+    auto const vertexOffset{ static_cast<u32>(base.vertex) };
+
+    std::copy(data.positions.begin(), data.positions.end(), positions.begin() + base.vertex * 3);
+    std::copy(data.uvs.begin(), data.uvs.end(), uvs.begin() + base.vertex * 2);
+    std::copy(data.normals.begin(), data.normals.end(), normals.begin() + base.vertex);
+    std::copy(data.meshletTriangles.begin(), data.meshletTriangles.end(), meshletTriangles.begin() + base.meshletTriangle);
+
+    std::transform(data.meshletVertices.begin(), data.meshletVertices.end(), meshletVertices.begin() + base.meshletVertex, [vertexOffset](u32 vertex){
+        return vertexOffset + vertex;
+    });
+
+    std::transform(data.meshlets.begin(), data.meshlets.end(), meshlets.begin() + base.meshlet, [&base, meshIndex](Meshlet meshlet){
+        meshlet.vertexOffset += static_cast<u32>(base.meshletVertex);
+        meshlet.triangleOffset += static_cast<u32>(base.meshletTriangle);
+        meshlet.mesh = static_cast<u16>(meshIndex);
+
+        return meshlet;
+    });
+
+    params[meshIndex] = data.params;
+    params[meshIndex].vertexOffset = vertexOffset;
+
+    packIndices(data, indices.data() + base.indexWord);
+
+    auto mesh{ data.mesh };
+    auto const indexOffset{ static_cast<u32>(mesh.indexSize == sizeof(u16) ? base.indexWord * 2 : base.indexWord) };
+
+    mesh.vertexOffset = vertexOffset;
+    mesh.indexOffset += indexOffset;
+    mesh.meshletOffset = static_cast<u32>(base.meshlet);
+
+    for (auto& lod : std::span{ mesh.lods, mesh.lodCount })
+    {
+        lod.indexOffset += indexOffset;
+    }
+
+    return mesh;
+}
+
+// Welds identical vertices, then reorders triangles for the post-transform cache and for
+// overdraw, and finally vertices for fetch locality. Order matters: overdraw optimization
+// keeps the cache order within clusters, and the fetch pass must see the final index order.
+auto MeshLoader::optimizeMesh(
+    std::string_view name,
+    std::vector<f32>& meshPositions,
+    std::vector<f32>& meshNormals,
+    std::vector<f32>& meshUvs,
+    std::vector<u32>& meshIndices
+) -> void
+{
+    LF_PROFILE_ZONE("MeshLoader::optimizeMesh");
+
+    constexpr auto cacheSize    { 16u };
+    constexpr auto warpSize     { 32u };
+    constexpr auto primGroupSize{ 32u };
+    constexpr auto overdrawSlack{ 1.05f };
+    constexpr auto vertexSize   { 3 * sizeof(u16) + sizeof(u32) + 2 * sizeof(u16) };
+
+    auto const indexCount { meshIndices.size() };
+    auto const sourceCount{ meshUvs.size() >> 1 };
+    auto vertexCount{ sourceCount };
+
+    if (indexCount == 0 || vertexCount == 0)
+    {
+        return;
+    }
+
+    auto const cacheBefore   { meshopt_analyzeVertexCache(meshIndices.data(), indexCount, vertexCount, cacheSize, warpSize, primGroupSize) };
+    auto const overdrawBefore{ meshopt_analyzeOverdraw(meshIndices.data(), indexCount, meshPositions.data(), vertexCount, 3 * sizeof(f32)) };
+    auto const fetchBefore   { meshopt_analyzeVertexFetch(meshIndices.data(), indexCount, vertexCount, vertexSize) };
+
+    auto const streams{ std::array{
+        meshopt_Stream{ meshPositions.data(), 3 * sizeof(f32), 3 * sizeof(f32) },
+        meshopt_Stream{ meshNormals.data(),   3 * sizeof(f32), 3 * sizeof(f32) },
+        meshopt_Stream{ meshUvs.data(),       2 * sizeof(f32), 2 * sizeof(f32) }
+    }};
+
+    auto remap{ std::vector<u32>(vertexCount) };
+    auto const uniqueCount{ meshopt_generateVertexRemapMulti(remap.data(), meshIndices.data(), indexCount, vertexCount, streams.data(), streams.size()) };
+
+    auto const applyRemap{ [&](size_t newCount){
+        meshopt_remapIndexBuffer(meshIndices.data(), meshIndices.data(), indexCount, remap.data());
+        meshopt_remapVertexBuffer(meshPositions.data(), meshPositions.data(), vertexCount, 3 * sizeof(f32), remap.data());
+        meshopt_remapVertexBuffer(meshNormals.data(), meshNormals.data(), vertexCount, 3 * sizeof(f32), remap.data());
+        meshopt_remapVertexBuffer(meshUvs.data(), meshUvs.data(), vertexCount, 2 * sizeof(f32), remap.data());
+
+        vertexCount = newCount;
+        meshPositions.resize(vertexCount * 3);
+        meshNormals.resize(vertexCount * 3);
+        meshUvs.resize(vertexCount * 2);
+    }};
+
+    applyRemap(uniqueCount);
+
+    meshopt_optimizeVertexCache(meshIndices.data(), meshIndices.data(), indexCount, vertexCount);
+    meshopt_optimizeOverdraw(meshIndices.data(), meshIndices.data(), indexCount, meshPositions.data(), vertexCount, 3 * sizeof(f32), overdrawSlack);
+
+    remap.resize(vertexCount);
+    applyRemap(meshopt_optimizeVertexFetchRemap(remap.data(), meshIndices.data(), indexCount, vertexCount));
+
+    auto const cacheAfter   { meshopt_analyzeVertexCache(meshIndices.data(), indexCount, vertexCount, cacheSize, warpSize, primGroupSize) };
+    auto const overdrawAfter{ meshopt_analyzeOverdraw(meshIndices.data(), indexCount, meshPositions.data(), vertexCount, 3 * sizeof(f32)) };
+    auto const fetchAfter   { meshopt_analyzeVertexFetch(meshIndices.data(), indexCount, vertexCount, vertexSize) };
+
+    spdlog::info(
+        "Optimized mesh [ name: {}; vertices: {} -> {}; acmr: {:.3f} -> {:.3f}; atvr: {:.3f} -> {:.3f}; overdraw: {:.3f} -> {:.3f}; overfetch: {:.3f} -> {:.3f} ]",
+        name,
+        sourceCount,
+        vertexCount,
+        cacheBefore.acmr,
+        cacheAfter.acmr,
+        cacheBefore.atvr,
+        cacheAfter.atvr,
+        overdrawBefore.overdraw,
+        overdrawAfter.overdraw,
+        fetchBefore.overfetch,
+        fetchAfter.overfetch
+    );
+}
+
+// Meshlets are built on the optimized index order. Vertex indices are rebased onto the shared
+// vertex arrays in placeMesh, so shaders can fetch without knowing which mesh a meshlet came from.
+auto MeshLoader::buildMeshlets(MeshData& data, std::vector<f32> const& meshPositions, std::vector<u32> const& meshIndices) -> void
+{
+    LF_PROFILE_ZONE("MeshLoader::buildMeshlets");
+
+    constexpr auto coneWeight{ 0.25f };
+
+    auto const vertexCount{ meshPositions.size() / 3 };
+    auto const maxMeshlets{ meshopt_buildMeshletsBound(meshIndices.size(), maxMeshletVertices, maxMeshletTriangles) };
+
+    auto localMeshlets { std::vector<meshopt_Meshlet>(maxMeshlets) };
+    auto localVertices { std::vector<u32>(maxMeshlets * maxMeshletVertices) };
+    auto localTriangles{ std::vector<u8>(maxMeshlets * maxMeshletTriangles * 3) };
+
+    auto const meshletCount{ meshopt_buildMeshlets(
+        localMeshlets.data(),
+        localVertices.data(),
+        localTriangles.data(),
+        meshIndices.data(),
+        meshIndices.size(),
+        meshPositions.data(),
+        vertexCount,
+        3 * sizeof(f32),
+        maxMeshletVertices,
+        maxMeshletTriangles,
+        coneWeight
+    )};
+
+    data.mesh.meshletCount = static_cast<u32>(meshletCount);
+    data.meshlets.reserve(meshletCount);
+
+    for (auto const& local : std::span{ localMeshlets.data(), meshletCount })
+    {
+        auto const bounds{ meshopt_computeMeshletBounds(
+            &localVertices[local.vertex_offset],
+            &localTriangles[local.triangle_offset],
+            local.triangle_count,
+            meshPositions.data(),
+            vertexCount,
+            3 * sizeof(f32)
+        )};
+
+        data.meshlets.emplace_back(Meshlet{
+            .center = { bounds.center[0], bounds.center[1], bounds.center[2] },
+            .radius = bounds.radius,
+            .coneAxis = { bounds.cone_axis_s8[0], bounds.cone_axis_s8[1], bounds.cone_axis_s8[2] },
+            .coneCutoff = bounds.cone_cutoff_s8,
+            .vertexOffset = static_cast<u32>(data.meshletVertices.size()),
+            .triangleOffset = static_cast<u32>(data.meshletTriangles.size()),
+            .vertexCount = static_cast<u8>(local.vertex_count),
+            .triangleCount = static_cast<u8>(local.triangle_count)
+        });
+
+        data.meshletVertices.insert(
+            data.meshletVertices.end(),
+            localVertices.begin() + local.vertex_offset,
+            localVertices.begin() + local.vertex_offset + local.vertex_count
+        );
+
+        data.meshletTriangles.insert(
+            data.meshletTriangles.end(),
+            localTriangles.begin() + local.triangle_offset,
+            localTriangles.begin() + local.triangle_offset + local.triangle_count * 3
+        );
+    }
+
+    spdlog::info("Built meshlets [ meshlets: {}; triangles: {} ]", meshletCount, meshIndices.size() / 3);
+}
+
+// Positions become unorm fixed point over the mesh bounds, UVs half floats and normals an
+// octahedral snorm pair packed into 32 bits. The decode parameters go into data.params.
+auto MeshLoader::quantizeMesh(
+    MeshData& data,
+    std::vector<f32> const& meshPositions,
+    std::vector<f32> const& meshNormals,
+    std::vector<f32> const& meshUvs
+) -> void
+{
+    LF_PROFILE_ZONE("MeshLoader::quantizeMesh");
+
+    auto const vertexCount{ meshUvs.size() >> 1 };
+    auto const positionMax{ static_cast<f32>((1u << m.quantization.positionBits) - 1) };
+
+    auto const& bounds{ data.mesh.bounds = computeBounds(meshPositions) };
+
+    auto& meshParams{ data.params };
+    meshParams.normalBits = m.quantization.normalBits;
+
+    auto inverseScale{ std::array<f32, 3>{} };
+
+    for (auto axis{ 0u }; axis < 3; ++axis)
+    {
+        auto const extent{ bounds.extent[axis] * 2.f };
+
+        meshParams.positionOffset[axis] = bounds.center[axis] - bounds.extent[axis];
+        meshParams.positionScale[axis] = extent / positionMax;
+        inverseScale[axis] = extent > 0.f ? positionMax / extent : 0.f;
+    }
+
+    data.positions.reserve(vertexCount * 3);
+    data.normals.reserve(vertexCount);
+    data.uvs.reserve(vertexCount * 2);
+
+    for (auto i{ size_t{} }; i < vertexCount; ++i)
+    {
+        for (auto axis{ 0u }; axis < 3; ++axis)
+        {
+            auto const position{ (meshPositions[i * 3 + axis] - meshParams.positionOffset[axis]) * inverseScale[axis] };
+            data.positions.emplace_back(static_cast<u16>(std::clamp(position + 0.5f, 0.f, positionMax)));
+        }
+
+        auto x{ meshNormals[i * 3] }, y{ meshNormals[i * 3 + 1] }, z{ meshNormals[i * 3 + 2] };
+        auto const length{ std::abs(x) + std::abs(y) + std::abs(z) };
+
+        x = length > 0.f ? x / length : 0.f;
+        y = length > 0.f ? y / length : 0.f;
+
+        if (z < 0.f)
+        {
+            auto const foldedX{ (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f) };
+            auto const foldedY{ (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f) };
+
+            x = foldedX;
+            y = foldedY;
         }
+
+        auto const octX{ static_cast<u16>(meshopt_quantizeSnorm(x, static_cast<i32>(m.quantization.normalBits))) };
+        auto const octY{ static_cast<u16>(meshopt_quantizeSnorm(y, static_cast<i32>(m.quantization.normalBits))) };
+
+        data.normals.emplace_back(u32{ octX } | u32{ octY } << 16);
+
+        data.uvs.emplace_back(meshopt_quantizeHalf(meshUvs[i * 2]));
+        data.uvs.emplace_back(meshopt_quantizeHalf(meshUvs[i * 2 + 1]));
     }
 
-    result.indexCount = static_cast<u32>(indices.size()) - result.indexOffset,
-    result.vertexCount = static_cast<u32>(uvs.size() >> 1) - result.vertexOffset;
+    spdlog::info(
+        "Quantized mesh [ vertices: {}; bytes: {} -> {} ]",
+        vertexCount,
+        vertexCount * 8 * sizeof(f32),
+        vertexCount * (3 * sizeof(u16) + sizeof(u32) + 2 * sizeof(u16))
+    );
+}
+
+// Each level simplifies the previous one to half its triangles, falling back to the sloppy
+// simplifier once topology-preserving simplification stalls. Errors are absolute object-space
+// distances accumulated along the chain, so they can be projected to pixels when drawing.
+auto MeshLoader::buildLods(MeshData& data, std::vector<f32> const& meshPositions, std::vector<u32> const& meshIndices) -> void
+{
+    LF_PROFILE_ZONE("MeshLoader::buildLods");
+
+    constexpr auto targetError     { 1e-1f };
+    constexpr auto minimumTriangles{ size_t{ 64 } };
 
-    return result;
-}
\ No newline at end of file
+    auto const vertexCount{ meshPositions.size() / 3 };
+    auto const scale      { vertexCount ? meshopt_simplifyScale(meshPositions.data(), vertexCount, 3 * sizeof(f32)) : 0.f };
+    auto const alignment  { data.mesh.indexSize == sizeof(u16) ? size_t{ 2 } : size_t{ 1 } };
+
+    auto lod  { meshIndices };
+    auto error{ 0.f };
+
+    data.indices.clear();
+    data.mesh.lodCount = 0;
+
+    while (true)
+    {
+        data.mesh.lods[data.mesh.lodCount++] = MeshLod{
+            .indexOffset = static_cast<u32>(data.indices.size()),
+            .indexCount = static_cast<u32>(lod.size()),
+            .error = error
+        };
+
+        data.indices.insert(data.indices.end(), lod.begin(), lod.end());
+        data.indices.resize((data.indices.size() + alignment - 1) / alignment * alignment);
+
+        if (data.mesh.lodCount == Mesh::maxLods || lod.size() / 3 <= minimumTriangles)
+        {
+            break;
+        }
+
+        auto const stalled{ [&lod](size_t count){ return count == 0 || count > lod.size() * 9 / 10; } };
+        auto const target { lod.size() / 6 * 3 };
+        auto simplified   { std::vector<u32>(lod.size()) };
+        auto levelError   { 0.f };
+
+        auto count{ meshopt_simplify(
+            simplified.data(),
+            lod.data(),
+            lod.size(),
+            meshPositions.data(),
+            vertexCount,
+            3 * sizeof(f32),
+            target,
+            targetError,
+            0,
+            &levelError
+        )};
+
+        if (stalled(count))
+        {
+            count = meshopt_simplifySloppy(
+                simplified.data(),
+                lod.data(),
+                lod.size(),
+                meshPositions.data(),
+                vertexCount,
+                3 * sizeof(f32),
+                target,
+                targetError,
+                &levelError
+            );
+        }
+
+        if (stalled(count))
+        {
+            break;
+        }
+
+        simplified.resize(count);
+        meshopt_optimizeVertexCache(simplified.data(), simplified.data(), count, vertexCount);
+
+        error += levelError * scale;
+        lod = std::move(simplified);
+    }
+
+    data.mesh.indexOffset = 0;
+    data.mesh.indexCount = data.mesh.lods[0].indexCount;
+
+    spdlog::info(
+        "Built LODs [ levels: {}; triangles: {} -> {}; error: {:.5f} ]",
+        data.mesh.lodCount,
+        meshIndices.size() / 3,
+        lod.size() / 3,
+        error
+    );
+}
+
+// Meshes with at most 65536 vertices store two indices per word. Every mesh starts on a word
+// boundary, which keeps 32-bit offsets exact when the same buffer is bound as either type.
+auto MeshLoader::packIndices(MeshData const& data, u32* words) -> void
+{
+    if (data.mesh.indexSize == sizeof(u32))
+    {
+        std::copy(data.indices.begin(), data.indices.end(), words);
+        return;
+    }
+
+    for (auto i{ size_t{} }; i < data.indices.size(); i += 2)
+    {
+        auto const second{ i + 1 < data.indices.size() ? data.indices[i + 1] : 0u };
+
+        words[i >> 1] = data.indices[i] | second << 16;
+    }
+}
+
+// Box over interleaved xyz positions, then the sphere around its center through the farthest
+// vertex. Blocks of four vertices are twelve floats, so lane k of the reduction always sees axis
+// k % 3 and the loop body is contiguous min/max over three four-wide registers.
+auto MeshLoader::computeBounds(std::vector<f32> const& positions) -> MeshBounds
+{
+    constexpr auto lanes{ 12u };
+
+    auto const vertexCount{ positions.size() / 3 };
+
+    if (!vertexCount)
+    {
+        return MeshBounds{};
+    }
+
+    auto minimum{ std::array<f32, lanes>{} };
+    auto maximum{ std::array<f32, lanes>{} };
+
+    minimum.fill(FLT_MAX);
+    maximum.fill(-FLT_MAX);
+
+    auto const blockEnd{ vertexCount / 4 * lanes };
+    auto const* source{ positions.data() };
+
+    for (auto i{ size_t{} }; i < blockEnd; i += lanes)
+    {
+        for (auto lane{ 0u }; lane < lanes; ++lane)
+        {
+            minimum[lane] = std::min(minimum[lane], source[i + lane]);
+            maximum[lane] = std::max(maximum[lane], source[i + lane]);
+        }
+    }
+
+    for (auto i{ blockEnd }; i < vertexCount * 3; ++i)
+    {
+        minimum[i % 3] = std::min(minimum[i % 3], source[i]);
+        maximum[i % 3] = std::max(maximum[i % 3], source[i]);
+    }
+
+    auto bounds{ MeshBounds{} };
+
+    for (auto axis{ 0u }; axis < 3; ++axis)
+    {
+        for (auto lane{ axis + 3 }; lane < lanes; lane += 3)
+        {
+            minimum[axis] = std::min(minimum[axis], minimum[lane]);
+            maximum[axis] = std::max(maximum[axis], maximum[lane]);
+        }
+
+        bounds.extent[axis] = (maximum[axis] - minimum[axis]) * 0.5f;
+        bounds.center[axis] = minimum[axis] + bounds.extent[axis];
+    }
+
+    auto radiusSquared{ 0.f };
+
+    for (auto i{ size_t{} }; i < vertexCount; ++i)
+    {
+        auto const x{ source[i * 3] - bounds.center[0] };
+        auto const y{ source[i * 3 + 1] - bounds.center[1] };
+        auto const z{ source[i * 3 + 2] - bounds.center[2] };
+
+        radiusSquared = std::max(radiusSquared, x * x + y * y + z * z);
+    }
+
+    bounds.radius = std::sqrt(radiusSquared);
+
+    return bounds;
+}
+
+auto MeshLoader::getIndexWordCount(MeshData const& data) -> size_t
+{
+    return data.mesh.indexSize == sizeof(u16) ? (data.indices.size() + 1) >> 1 : data.indices.size();
+}
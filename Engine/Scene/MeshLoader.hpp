@@ -1,27 +1,117 @@
 #pragma once
 #include "Mesh.hpp"
+#include "MeshCache.hpp"
 #include <string_view>
 #include <assimp/scene.h>
 #include <vector>
 
+class JobSystem;
+
 class MeshLoader
 {
+public:
+    // Bit depths of the quantized vertex streams. Positions are unorm relative to the mesh
+    // bounds, up to 16 bits; normals are an octahedral snorm pair, up to 16 bits per component.
+    struct Quantization
+    {
+        u32 positionBits;
+        u32 normalBits;
+    };
+
+public:
+    MeshLoader();
+    explicit MeshLoader(JobSystem* jobs);
+    MeshLoader(Quantization const& quantization, JobSystem* jobs = nullptr);
+
 public:
     auto loadMesh(std::string_view path, bool flipUV) -> std::vector<Mesh>;
 
+    // Shifts everything this loader imported so it starts at the given bases instead of zero,
+    // as if it had been imported into a loader already holding that much geometry. Streams are
+    // only shifted from first on, so geometry appended after earlier imports can be rebased alone.
+    auto rebase(cache::MeshBases const& bases, std::vector<Mesh>& meshes, cache::MeshBases const& first = {}) -> void;
+
+    inline auto setCacheEnabled(bool enabled) noexcept -> void
+    {
+        m.cacheEnabled = enabled;
+    }
+
 private:
-    auto processNode(aiNode* pNode, aiScene const* pScene) -> void;
-    auto processMesh(aiMesh* pMesh, aiScene const* pScene) -> Mesh;
+    // One converted aiMesh before it is placed into the shared arrays. Offsets in mesh and
+    // meshlets are local to these vectors; indices are unpacked, with every LOD starting on a
+    // word boundary of the packed layout.
+    struct MeshData
+    {
+        Mesh                 mesh;
+        MeshParams           params;
+        std::vector<u16>     positions;
+        std::vector<u16>     uvs;
+        std::vector<u32>     normals;
+        std::vector<u32>     indices;
+        std::vector<Meshlet> meshlets;
+        std::vector<u32>     meshletVertices;
+        std::vector<u8>      meshletTriangles;
+    };
+
+    // First element of a mesh in each shared array, from the prefix sums over all meshes.
+    struct MeshBase
+    {
+        size_t vertex;
+        size_t indexWord;
+        size_t meshlet;
+        size_t meshletVertex;
+        size_t meshletTriangle;
+    };
+
+private:
+    auto getCacheOptions(bool flipUV) const -> u64;
+    auto importScene(aiScene const* pScene) -> void;
+    auto collectMeshes(aiNode* pNode, aiScene const* pScene, std::vector<aiMesh*>& meshes) -> void;
+    auto processMesh(aiMesh* pMesh, MeshData& data) -> void;
+    auto placeMesh(MeshData const& data, MeshBase const& base, u32 meshIndex) -> Mesh;
+    auto optimizeMesh(
+        std::string_view name,
+        std::vector<f32>& meshPositions,
+        std::vector<f32>& meshNormals,
+        std::vector<f32>& meshUvs,
+        std::vector<u32>& meshIndices
+    ) -> void;
+    auto buildMeshlets(MeshData& data, std::vector<f32> const& meshPositions, std::vector<u32> const& meshIndices) -> void;
+    auto quantizeMesh(
+        MeshData& data,
+        std::vector<f32> const& meshPositions,
+        std::vector<f32> const& meshNormals,
+        std::vector<f32> const& meshUvs
+    ) -> void;
+    auto buildLods(MeshData& data, std::vector<f32> const& meshPositions, std::vector<u32> const& meshIndices) -> void;
+    auto packIndices(MeshData const& data, u32* words) -> void;
+
+    static auto getIndexWordCount(MeshData const& data) -> size_t;
+    static auto computeBounds(std::vector<f32> const& positions) -> MeshBounds;
 
 public:
+    static constexpr auto maxMeshletVertices { 64u };
+    static constexpr auto maxMeshletTriangles{ 124u };
+
+public:
+    // Packed index words; see Mesh::indexSize.
     std::vector<u32> indices;
-    std::vector<f32> positions;
-    std::vector<f32> uvs;
-    std::vector<u8>  normals;
+    std::vector<u16> positions;
+    std::vector<u16> uvs;
+    std::vector<u32> normals;
+
+    std::vector<MeshParams> params;
+
+    std::vector<Meshlet> meshlets;
+    std::vector<u32>     meshletVertices;
+    std::vector<u8>      meshletTriangles;
 
 private:
     struct M
     {
         std::vector<Mesh> result;
+        Quantization      quantization;
+        JobSystem*        jobs;
+        bool              cacheEnabled{ true };
     } m;
-};
\ No newline at end of file
+};
@@ -0,0 +1,138 @@
+#include "TransformStore.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+auto TransformStore::add(Transform const& transform) -> u32
+{
+    auto const index{ this->size() };
+
+    m.positionX.emplace_back();
+    m.positionY.emplace_back();
+    m.positionZ.emplace_back();
+    m.rotationX.emplace_back();
+    m.rotationY.emplace_back();
+    m.rotationZ.emplace_back();
+    m.rotationW.emplace_back();
+    m.scale.emplace_back();
+
+    this->set(index, transform);
+
+    return index;
+}
+
+auto TransformStore::set(u32 index, Transform const& transform) -> void
+{
+    if (index >= this->size())
+    {
+        throw std::runtime_error("Failed to set transform: index out of range");
+    }
+
+    m.positionX[index] = transform.position[0];
+    m.positionY[index] = transform.position[1];
+    m.positionZ[index] = transform.position[2];
+    m.rotationX[index] = transform.rotation[0];
+    m.rotationY[index] = transform.rotation[1];
+    m.rotationZ[index] = transform.rotation[2];
+    m.rotationW[index] = transform.rotation[3];
+    m.scale[index] = transform.scale;
+
+    this->markDirty(index, index + 1);
+}
+
+auto TransformStore::get(u32 index) const -> Transform
+{
+    if (index >= this->size())
+    {
+        throw std::runtime_error("Failed to get transform: index out of range");
+    }
+
+    return Transform{
+        .position = { m.positionX[index], m.positionY[index], m.positionZ[index] },
+        .rotation = { m.rotationX[index], m.rotationY[index], m.rotationZ[index], m.rotationW[index] },
+        .scale = m.scale[index]
+    };
+}
+
+auto TransformStore::translate(u32 first, u32 count, f32 x, f32 y, f32 z) -> void
+{
+    if (first > this->size() || count > this->size() - first)
+    {
+        throw std::runtime_error("Failed to translate transforms: range out of bounds");
+    }
+
+    auto* __restrict positionX{ m.positionX.data() + first };
+    auto* __restrict positionY{ m.positionY.data() + first };
+    auto* __restrict positionZ{ m.positionZ.data() + first };
+
+    for (auto i{ u32{} }; i < count; ++i)
+    {
+        positionX[i] += x;
+    }
+
+    for (auto i{ u32{} }; i < count; ++i)
+    {
+        positionY[i] += y;
+    }
+
+    for (auto i{ u32{} }; i < count; ++i)
+    {
+        positionZ[i] += z;
+    }
+
+    this->markDirty(first, first + count);
+}
+
+// Writes the three rows of the affine matrix of instances first to first + count, 12 floats at each
+// stride bytes from rows, with the translation in the last column. Rotations are assumed to be
+// unit quaternions.
+auto TransformStore::writeRows(f32* rows, size_t stride, u32 first, u32 count) const -> void
+{
+    if (first > this->size() || count > this->size() - first)
+    {
+        throw std::runtime_error("Failed to write transform rows: range out of bounds");
+    }
+
+    auto* bytes{ reinterpret_cast<u8*>(rows) };
+
+    for (auto i{ first }, end{ first + count }; i < end; ++i)
+    {
+        auto const x{ m.rotationX[i] }, y{ m.rotationY[i] }, z{ m.rotationZ[i] }, w{ m.rotationW[i] };
+        auto const s{ m.scale[i] };
+
+        auto* row{ reinterpret_cast<f32*>(bytes + (i - first) * stride) };
+
+        row[0]  = (1.f - 2.f * (y * y + z * z)) * s;
+        row[1]  = 2.f * (x * y - z * w) * s;
+        row[2]  = 2.f * (x * z + y * w) * s;
+        row[3]  = m.positionX[i];
+        row[4]  = 2.f * (x * y + z * w) * s;
+        row[5]  = (1.f - 2.f * (x * x + z * z)) * s;
+        row[6]  = 2.f * (y * z - x * w) * s;
+        row[7]  = m.positionY[i];
+        row[8]  = 2.f * (x * z - y * w) * s;
+        row[9]  = 2.f * (y * z + x * w) * s;
+        row[10] = (1.f - 2.f * (x * x + y * y)) * s;
+        row[11] = m.positionZ[i];
+    }
+}
+
+auto TransformStore::markDirty(u32 first, u32 end) -> void
+{
+    if (first == end)
+    {
+        return;
+    }
+
+    if (m.dirtyFirst == m.dirtyEnd)
+    {
+        m.dirtyFirst = first;
+        m.dirtyEnd = end;
+    }
+    else
+    {
+        m.dirtyFirst = std::min(m.dirtyFirst, first);
+        m.dirtyEnd = std::max(m.dirtyEnd, end);
+    }
+
+    ++m.version;
+}
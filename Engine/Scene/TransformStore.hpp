@@ -0,0 +1,73 @@
+#pragma once
+#include "Types.hpp"
+#include <array>
+#include <vector>
+
+// Placement of one instance: position, rotation quaternion (x, y, z, w) and uniform scale.
+struct Transform
+{
+    f32 position[3]{};
+    f32 rotation[4]{ 0.f, 0.f, 0.f, 1.f };
+    f32 scale{ 1.f };
+};
+
+// Instance transforms as a structure of arrays, so bulk updates stream over one contiguous
+// component at a time and vectorise. Every change bumps the version and grows the dirty range,
+// the one span covering every instance changed since the consumer last cleared it, so the consumer
+// re-packs only that span.
+class TransformStore
+{
+public:
+    auto add(Transform const& transform) -> u32;
+    auto set(u32 index, Transform const& transform) -> void;
+    auto get(u32 index) const -> Transform;
+    auto translate(u32 first, u32 count, f32 x, f32 y, f32 z) -> void;
+    auto writeRows(f32* rows, size_t stride, u32 first, u32 count) const -> void;
+
+public:
+    inline auto size() const noexcept -> u32
+    {
+        return static_cast<u32>(m.scale.size());
+    }
+
+    inline auto getScales() const noexcept -> std::vector<f32> const&
+    {
+        return m.scale;
+    }
+
+    inline auto getVersion() const noexcept -> u64
+    {
+        return m.version;
+    }
+
+    // Changed instances as [first, end); empty when first == end.
+    inline auto getDirtyRange() const noexcept -> std::array<u32, 2>
+    {
+        return { m.dirtyFirst, m.dirtyEnd };
+    }
+
+    inline auto clearDirty() noexcept -> void
+    {
+        m.dirtyFirst = 0;
+        m.dirtyEnd = 0;
+    }
+
+private:
+    auto markDirty(u32 first, u32 end) -> void;
+
+private:
+    struct M
+    {
+        std::vector<f32> positionX;
+        std::vector<f32> positionY;
+        std::vector<f32> positionZ;
+        std::vector<f32> rotationX;
+        std::vector<f32> rotationY;
+        std::vector<f32> rotationZ;
+        std::vector<f32> rotationW;
+        std::vector<f32> scale;
+        u64              version{};
+        u32              dirtyFirst{};
+        u32              dirtyEnd{};
+    } m;
+};
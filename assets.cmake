@@ -22,6 +22,8 @@ file(GLOB_RECURSE GLSL_SOURCE_FILES
     Data/Shaders/*.frag
     Data/Shaders/*.vert
     Data/Shaders/*.comp
+    Data/Shaders/*.task
+    Data/Shaders/*.mesh
 )
 
 foreach(GLSL ${GLSL_SOURCE_FILES})
@@ -40,4 +42,5 @@ add_custom_target(
     DEPENDS ${SPIRV_BINARY_FILES}
 )
 
-add_dependencies(LightFrame Shaders)
\ No newline at end of file
+add_dependencies(LightFrame Shaders)
+add_dependencies(LightFrameBench Shaders)
\ No newline at end of file
@@ -111,27 +111,29 @@ FetchContent_MakeAvailable(
     imgui
 )
 
-target_sources(LightFrame PRIVATE
-    ${imgui_SOURCE_DIR}/imgui.cpp
-    ${imgui_SOURCE_DIR}/imgui_demo.cpp
-    ${imgui_SOURCE_DIR}/imgui_draw.cpp
-    ${imgui_SOURCE_DIR}/imgui_tables.cpp
-    ${imgui_SOURCE_DIR}/imgui_widgets.cpp
-    ${imgui_SOURCE_DIR}/backends/imgui_impl_sdl3.cpp
-)
-
-target_include_directories(LightFrame PRIVATE
-    ${stb_SOURCE_DIR}/
-    ${imgui_SOURCE_DIR}/
-    ${Vulkan_INCLUDE_DIR}/
-)
-
-target_link_libraries(LightFrame PRIVATE
-    GPUOpen::VulkanMemoryAllocator
-    SDL3::SDL3-static
-    spdlog::spdlog
-    meshoptimizer
-    glm::glm-header-only
-    assimp
-    volk
-)
\ No newline at end of file
+foreach(LF_TARGET LightFrame LightFrameBench)
+    target_sources(${LF_TARGET} PRIVATE
+        ${imgui_SOURCE_DIR}/imgui.cpp
+        ${imgui_SOURCE_DIR}/imgui_demo.cpp
+        ${imgui_SOURCE_DIR}/imgui_draw.cpp
+        ${imgui_SOURCE_DIR}/imgui_tables.cpp
+        ${imgui_SOURCE_DIR}/imgui_widgets.cpp
+        ${imgui_SOURCE_DIR}/backends/imgui_impl_sdl3.cpp
+    )
+
+    target_include_directories(${LF_TARGET} PRIVATE
+        ${stb_SOURCE_DIR}/
+        ${imgui_SOURCE_DIR}/
+        ${Vulkan_INCLUDE_DIR}/
+    )
+
+    target_link_libraries(${LF_TARGET} PRIVATE
+        GPUOpen::VulkanMemoryAllocator
+        SDL3::SDL3-static
+        spdlog::spdlog
+        meshoptimizer
+        glm::glm-header-only
+        assimp
+        volk
+    )
+endforeach()